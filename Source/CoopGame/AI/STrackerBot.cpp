@@ -2,15 +2,30 @@
 #include "Components/StaticMeshComponent.h"
 #include "NavigationSystem.h"
 #include "Kismet/GameplayStatics.h"
-#include "NavigationPath.h"
+#include "NavigationData.h"
 #include "GameFramework/Character.h"
 #include "DrawDebugHelpers.h"
 #include "SHealthComponent.h"
-#include "Materials/MaterialInstanceDynamic.h"
 #include "Components/SphereComponent.h"
 #include "SCharacter.h"
 #include "TimerManager.h"
 #include "Sound/SoundCue.h"
+#include "SAssetPreloader.h"
+#include "SGameMode.h"
+#include "SNetStats.h"
+#include "UnrealNetwork.h"
+#include "SBotMovementReplicator.h"
+#include "SBotRenderer.h"
+#include "SBotAvoidance.h"
+#include "SBotDecisions.h"
+#include "SHitboxRegistry.h"
+#include "SSpikeCatcher.h"
+#include "SCorpseManager.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "SMemoryTags.h"
+#include "GameFramework/GameStateBase.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Path Allocations"), STAT_BotPathAllocations, STATGROUP_CoopGame);
 
 static int32 DebugTrackerBotDrawing = 0;
 FAutoConsoleVariableRef CVARDebugTrackerBotDrawing(
@@ -19,6 +34,20 @@ FAutoConsoleVariableRef CVARDebugTrackerBotDrawing(
 	TEXT("Draw debug lines for TrackerBot"),
 	ECVF_Cheat);
 
+static float BotInterpolationDelay = 0.1f;
+FAutoConsoleVariableRef CVARBotInterpolationDelay(
+	TEXT("COOP.BotInterpolationDelay"),
+	BotInterpolationDelay,
+	TEXT("How far behind the server clients show bots, in seconds, so there is usually an update on either side to interpolate between"),
+	ECVF_Default);
+
+static float BotMaxExtrapolation = 0.25f;
+FAutoConsoleVariableRef CVARBotMaxExtrapolation(
+	TEXT("COOP.BotMaxExtrapolation"),
+	BotMaxExtrapolation,
+	TEXT("How long clients keep moving a bot along its last known velocity when updates stop arriving, in seconds"),
+	ECVF_Default);
+
 // Sets default values
 ASTrackerBot::ASTrackerBot()
 {
@@ -30,7 +59,7 @@ ASTrackerBot::ASTrackerBot()
 	RootComponent = MeshComp;
 
 	HealthComp = CreateDefaultSubobject<USHealthComponent>(TEXT("HealthComp"));
-	HealthComp->OnHealthChanged.AddDynamic(this, &ASTrackerBot::HandleTakeDamage);
+	HealthComp->OnHealthChangedNative.AddUObject(this, &ASTrackerBot::HandleTakeDamage);
 
 	SphereComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	SphereComp->SetSphereRadius(200);
@@ -46,70 +75,322 @@ ASTrackerBot::ASTrackerBot()
 	ExplosionDamage = 40;
 	ExplosionRadius = 350;
 	SelfDamageInterval = 0.25f;
+	Avoidance = FVector::ZeroVector;
+
+	LastTimeDamageTaken = -BIG_NUMBER;
 }
 
 void ASTrackerBot::BeginPlay()
 {
+	COOP_LLM_SCOPE(ESMemoryTag::Bots);
 	Super::BeginPlay();
 
+	// Assets saved while this was a dynamic binding still carry it
+	HealthComp->OnHealthChanged.Remove(this, GET_FUNCTION_NAME_CHECKED(ASTrackerBot, HandleTakeDamage));
+
 	if (Role == ROLE_Authority) {
-		NextPathPoint = GetNextPathPoint();
+		ExplosionIgnoredActors.Reset();
+		ExplosionIgnoredActors.Add(this);
+
+		StartTracking();
+
+		// Movement goes out through the bot movement replicator instead
+		SetReplicateMovement(false);
+		if (auto Replicator = ASBotMovementReplicator::Get(GetWorld())) {
+			Replicator->RegisterBot(this);
+		}
+
+		if (auto Decisions = ASBotDecisions::Get(GetWorld())) {
+			Decisions->RegisterBot(this);
+		}
 
-		FTimerHandle TimerHandle_CheckPowerLevel;
-		GetWorldTimerManager().SetTimer(TimerHandle_CheckPowerLevel, this, &ASTrackerBot::OnCheckNearbyBots, 1.f, true);
+		// Steer with this frame's avoidance, not last frame's
+		if (auto AvoidanceManager = ASBotAvoidance::Get(GetWorld())) {
+			AvoidanceManager->RegisterBot(this);
+			AddTickPrerequisiteActor(AvoidanceManager);
+		}
+	} else {
+		// Clients place bots from the server's updates
+		MeshComp->SetSimulatePhysics(false);
+	}
+
+	// Keep MeshComp for collision but draw the bot as an instance
+	if (auto Renderer = ASBotRenderer::Get(GetWorld())) {
+		bInstanced = Renderer->RegisterBot(this);
+		MeshComp->SetHiddenInGame(bInstanced);
+	}
+
+	if (auto Hitboxes = ASHitboxRegistry::Get(GetWorld())) {
+		auto PhysMaterial = MeshComp->GetBodyInstance()->GetSimplePhysicalMaterial();
+		Hitboxes->AddHitbox(MeshComp, NAME_None, NAME_None, MeshComp->CalcLocalBounds().SphereRadius, UPhysicalMaterial::DetermineSurfaceType(PhysMaterial));
+	}
+
+	if (auto Preloader = ASAssetPreloader::Get(GetWorld())) {
+		Preloader->PreloadClass(GetClass());
 	}
 }
 
-void ASTrackerBot::HandleTakeDamage(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
-	const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+void ASTrackerBot::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (Role == ROLE_Authority) {
+		if (auto Replicator = ASBotMovementReplicator::Get(GetWorld())) {
+			Replicator->UnregisterBot(this);
+		}
+
+		if (auto AvoidanceManager = ASBotAvoidance::Get(GetWorld())) {
+			AvoidanceManager->UnregisterBot(this);
+		}
 
-	// Pulse material on hit
-	if (MatInst == nullptr) {
-		MatInst = MeshComp->CreateAndSetMaterialInstanceDynamicFromMaterial(0, MeshComp->GetMaterial(0));
+		if (auto Decisions = ASBotDecisions::Get(GetWorld())) {
+			Decisions->UnregisterBot(this);
+		}
 	}
 
-	if (MatInst) {
-		MatInst->SetScalarParameterValue("LastTimeDamageTaken", GetWorld()->TimeSeconds);
+	if (bInstanced) {
+		if (auto Renderer = ASBotRenderer::Get(GetWorld())) {
+			Renderer->UnregisterBot(this);
+		}
 	}
 
-	// Explode if health is 0
-	if (Health <= 0.f) {
-		SelfDestruct();
+	if (auto Hitboxes = ASHitboxRegistry::Get(GetWorld())) {
+		Hitboxes->RemoveHitboxes(this);
 	}
-	
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASTrackerBot::ReceiveMovement(float ServerTime, const FVector& NewLocation, const FVector& NewVelocity) {
+	// Unreliable updates can arrive out of order
+	if (MovementSnapshots.Num() > 0 && ServerTime <= MovementSnapshots.Last().ServerTime) { return; }
+
+	// First update after spawning or leaving the pool, nothing to interpolate from
+	if (MovementSnapshots.Num() == 0) {
+		SetActorLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	if (MovementSnapshots.Num() == 4) {
+		MovementSnapshots.RemoveAt(0, 1, false);
+	}
+
+	FMovementSnapshot Snapshot;
+	Snapshot.ServerTime = ServerTime;
+	Snapshot.Location = NewLocation;
+	Snapshot.Velocity = NewVelocity;
+	MovementSnapshots.Add(Snapshot);
+}
+
+void ASTrackerBot::TickSimulatedMovement(float DeltaTime) {
+	auto GS = GetWorld()->GetGameState();
+	if (MovementSnapshots.Num() == 0 || !GS) { return; }
+
+	const float RenderTime = GS->GetServerWorldTimeSeconds() - BotInterpolationDelay;
+	const FMovementSnapshot& Latest = MovementSnapshots.Last();
+
+	FVector NewLocation = MovementSnapshots[0].Location;
+
+	if (RenderTime >= Latest.ServerTime) {
+		NewLocation = Latest.Location + Latest.Velocity * FMath::Min(RenderTime - Latest.ServerTime, BotMaxExtrapolation);
+	} else {
+		for (int32 Index = MovementSnapshots.Num() - 1; Index > 0; --Index) {
+			const FMovementSnapshot& From = MovementSnapshots[Index - 1];
+			const FMovementSnapshot& To = MovementSnapshots[Index];
+			if (RenderTime < From.ServerTime) { continue; }
+
+			// Hermite spline through both updates, using their velocities as tangents
+			const float Span = To.ServerTime - From.ServerTime;
+			const float Alpha = (RenderTime - From.ServerTime) / Span;
+			NewLocation = FMath::CubicInterp(From.Location, From.Velocity * Span, To.Location, To.Velocity * Span, Alpha);
+			break;
+		}
+	}
+
+	// Roll the ball along the way it moved
+	const FVector Delta = NewLocation - GetActorLocation();
+	const float Radius = MeshComp->Bounds.SphereRadius;
+	if (Radius > KINDA_SMALL_NUMBER && !Delta.IsNearlyZero()) {
+		const FVector RollAxis = FVector::CrossProduct(FVector::UpVector, Delta).GetSafeNormal();
+		if (!RollAxis.IsZero()) {
+			AddActorWorldRotation(FQuat(RollAxis, Delta.Size2D() / Radius));
+		}
+	}
+
+	SetActorLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
 }
 
-FVector ASTrackerBot::GetNextPathPoint() {
-	AActor* BestTarget = nullptr;
-	float NearestTargetDistance = FLT_MAX;
+void ASTrackerBot::StartTracking() {
+	// ASBotDecisions finds a path on its next commit
+	NextPathPoint = GetActorLocation();
+	LastPathTime = -BIG_NUMBER;
+	NextPowerLevelCheckTime = GetWorld()->TimeSeconds + 1.f;
+}
+
+void ASTrackerBot::GetDecisionInput(FSBotDecisionInput& OutInput) const {
+	const float Now = GetWorld()->TimeSeconds;
+
+	OutInput.Location = GetActorLocation();
+	OutInput.NextPathPoint = NextPathPoint;
+	OutInput.Radius = MeshComp->Bounds.SphereRadius;
+	OutInput.RequiredDistanceToTarget = RequiredDistanceToTarget;
+	OutInput.SelfDestructRadius = SphereComp->GetScaledSphereRadius();
+	OutInput.TimeSinceLastPath = Now - LastPathTime;
+	OutInput.TeamNum = HealthComp->TeamNum;
+	OutInput.bCanSelfDestruct = !bStartedSelfDestruction;
+	OutInput.bCheckPowerLevel = Now >= NextPowerLevelCheckTime;
+}
+
+void ASTrackerBot::ApplyDecision(const FSBotDecision& Decision, APawn* Target) {
+	if (Decision.bSelfDestruct) {
+		StartSelfDestruction();
+	}
+
+	if (Decision.bRefreshPath && Target) {
+		if (DebugTrackerBotDrawing) {
+			DrawDebugString(GetWorld(), GetActorLocation(), "Refreshing Path");
+		}
 
-	for (auto It = GetWorld()->GetPawnIterator(); It; ++It) {
-		auto TestPawn = It->Get();
-		if (!TestPawn || USHealthComponent::IsFriendly(TestPawn, this)) continue;
+		NextPathPoint = FindNextPathPoint(Target);
+		LastPathTime = GetWorld()->TimeSeconds;
+	}
 
-		auto TestPawnHealthComp = Cast<USHealthComponent>(TestPawn->GetComponentByClass(USHealthComponent::StaticClass()));
+	if (Decision.PowerLevel != INDEX_NONE) {
+		SetPowerLevel(Decision.PowerLevel);
+		NextPowerLevelCheckTime = GetWorld()->TimeSeconds + 1.f;
 
-		if (TestPawnHealthComp && TestPawnHealthComp->GetHealth() > 0.f) {
-			float Distance = (TestPawn->GetActorLocation() - GetActorLocation()).Size();
-			if (Distance < NearestTargetDistance) {
-				BestTarget = TestPawn;
-				NearestTargetDistance = Distance;
-			}
+		if (DebugTrackerBotDrawing) {
+			DrawDebugSphere(GetWorld(), GetActorLocation(), 600.f, 12, FColor::White, false, 1.f);
 		}
 	}
+}
+
+void ASTrackerBot::Reset() {
+	// Skips APawn::Reset, which destroys pawns without a controller
+	AActor::Reset();
+
+	if (Role == ROLE_Authority && !bPooled) {
+		ReturnToPool();
+	}
+}
 
-	if (BestTarget) {
-		auto NavPath = UNavigationSystemV1::FindPathToActorSynchronously(this, GetActorLocation(), BestTarget);
+void ASTrackerBot::ReturnToPool() {
+	auto GM = Cast<ASGameMode>(GetWorld()->GetAuthGameMode());
+	if (!GM) {
+		Destroy();
+		return;
+	}
 
-		GetWorldTimerManager().ClearTimer(TimerHandle_RefreshPath);
-		GetWorldTimerManager().SetTimer(TimerHandle_RefreshPath, this, &ASTrackerBot::RefreshPath, 5.f, false);
+	Deactivate();
+	GM->ReleaseBot(this);
+}
+
+void ASTrackerBot::Deactivate() {
+	if (Role == ROLE_Authority) {
+		GetWorldTimerManager().ClearAllTimersForObject(this);
+		PowerLevel = 0;
+		Avoidance = FVector::ZeroVector;
 
-		if (NavPath && NavPath->PathPoints.Num() > 1) {
-			return NavPath->PathPoints[1];
+		bPooled = true;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASTrackerBot, bPooled));
+
+		// Nothing about a pooled bot changes, stop comparing it once clients know it's pooled
+		SetNetDormancy(DORM_DormantAll);
+
+		// A match reset can pool a bot that was still waiting as a corpse
+		if (auto Corpses = ASCorpseManager::Get(GetWorld())) {
+			Corpses->RemoveCorpse(this);
 		}
 	}
 
-	return GetActorLocation();
+	OnRep_Pooled();
+}
+
+void ASTrackerBot::Reactivate(const FTransform& SpawnTransform) {
+	if (Role < ROLE_Authority) { return; }
+
+	SetNetDormancy(DORM_Awake);
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	HealthComp->ResetHealth();
+
+	bPooled = false;
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASTrackerBot, bPooled));
+	OnRep_Pooled();
+
+	StartTracking();
+}
+
+void ASTrackerBot::OnRep_Pooled() {
+	if (Role < ROLE_Authority) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASTrackerBot, bPooled));
+	}
+
+	SetActorHiddenInGame(bPooled);
+	SetActorTickEnabled(!bPooled);
+
+	// The corpse manager freezes component ticks as well, so they come back with the actor's
+	TInlineComponentArray<UActorComponent*> Components;
+	GetComponents(Components);
+
+	for (UActorComponent* Component : Components) {
+		Component->SetComponentTickEnabled(!bPooled && Component->PrimaryComponentTick.bStartWithTickEnabled);
+	}
+
+	SphereComp->SetCollisionEnabled(bPooled ? ECollisionEnabled::NoCollision : ECollisionEnabled::QueryOnly);
+
+	if (bPooled) {
+		MeshComp->SetSimulatePhysics(false);
+		MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		MovementSnapshots.Reset();
+		return;
+	}
+
+	bExploded = false;
+	bStartedSelfDestruction = false;
+	LastTimeDamageTaken = -BIG_NUMBER;
+
+	MeshComp->SetVisibility(true, true);
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	MeshComp->SetSimulatePhysics(Role == ROLE_Authority);
+}
+
+void ASTrackerBot::HandleTakeDamage(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
+	const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+
+	// Pulse material on hit, ASBotRenderer picks this up
+	LastTimeDamageTaken = GetWorld()->TimeSeconds;
+
+	// Explode if health is 0
+	if (Health <= 0.f) {
+		SelfDestruct();
+	}
+	
+}
+
+SIZE_T ASTrackerBot::GetPathAllocatedSize() const {
+	if (!PathBuffer.IsValid()) { return 0; }
+
+	return sizeof(FNavigationPath) + PathBuffer->GetPathPoints().GetAllocatedSize();
+}
+
+FVector ASTrackerBot::FindNextPathPoint(APawn* Target) {
+	COOP_LLM_SCOPE(ESMemoryTag::Navigation);
+
+	auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	auto NavData = NavSys ? NavSys->GetNavDataForProps(GetNavAgentPropertiesRef()) : nullptr;
+	if (!NavData) { return GetActorLocation(); }
+
+	if (!PathBuffer.IsValid()) {
+		INC_DWORD_STAT(STAT_BotPathAllocations);
+	}
+
+	// Pathfinding stays on the game thread, only the decision to do it is made in parallel
+	FPathFindingQuery Query(this, *NavData, GetActorLocation(), Target->GetActorLocation(), NavData->GetDefaultQueryFilter(), PathBuffer);
+	FPathFindingResult Result = NavSys->FindPathSync(Query);
+	FSFrameCounters::Get(this).PathsRequested++;
+	if (!Result.IsSuccessful() || !Result.Path.IsValid()) { return GetActorLocation(); }
+
+	PathBuffer = Result.Path;
+
+	const TArray<FNavPathPoint>& PathPoints = PathBuffer->GetPathPoints();
+	return PathPoints.Num() > 1 ? PathPoints[1].Location : GetActorLocation();
 }
 
 void ASTrackerBot::SelfDestruct() {
@@ -117,26 +398,33 @@ void ASTrackerBot::SelfDestruct() {
 
 	bExploded = true;
 
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffects, GetActorLocation());
-	UGameplayStatics::PlaySoundAtLocation(this, ExplodeSound, GetActorLocation());
+	if (GetNetMode() != NM_DedicatedServer) {
+		// Skipped rather than loaded mid-fight if the preloader hasn't streamed them in yet
+		COOP_LLM_SCOPE(ESMemoryTag::Effects);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffects.Get(), GetActorLocation());
+		UGameplayStatics::PlaySoundAtLocation(this, ExplodeSound.Get(), GetActorLocation());
+	}
 
 	MeshComp->SetVisibility(false, true);
 	MeshComp->SetSimulatePhysics(false);
 	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 	if (Role == ROLE_Authority) {
-		TArray<AActor*> IgnoredActors;
-		IgnoredActors.Add(this);
-
 		float Damage = ExplosionDamage + (ExplosionDamage * PowerLevel);
 
-		UGameplayStatics::ApplyRadialDamage(this, Damage, GetActorLocation(), ExplosionRadius, nullptr, IgnoredActors, this, GetInstigatorController(), true);
+		UGameplayStatics::ApplyRadialDamage(this, Damage, GetActorLocation(), ExplosionRadius, nullptr, ExplosionIgnoredActors, this, GetInstigatorController(), true);
 
 		if (DebugTrackerBotDrawing) {
 			DrawDebugSphere(GetWorld(), GetActorLocation(), ExplosionRadius, 12, FColor::Red, false, 2.f, 0, 1.f);
 		}
 
-		SetLifeSpan(2.f);
+		// Leave time for clients to play the explosion before the bot is reused
+		GetWorldTimerManager().ClearTimer(TimerHandle_SelfDamage);
+		if (auto Corpses = ASCorpseManager::Get(GetWorld())) {
+			Corpses->AddCorpse(this, 2.f, FSimpleDelegate::CreateUObject(this, &ASTrackerBot::ReturnToPool));
+		} else {
+			GetWorldTimerManager().SetTimer(TimerHandle_ReturnToPool, this, &ASTrackerBot::ReturnToPool, 2.f, false);
+		}
 	}
 }
 
@@ -146,18 +434,20 @@ void ASTrackerBot::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (Role != ROLE_Authority || bExploded) { return; }
+	if (Role < ROLE_Authority) {
+		TickSimulatedMovement(DeltaTime);
+		return;
+	}
+
+	if (bExploded) { return; }
 
 	auto DistanceToTarget = (GetActorLocation() - NextPathPoint).Size();
 
-	if (DistanceToTarget <= RequiredDistanceToTarget) {
-		NextPathPoint = GetNextPathPoint();
-		if (DebugTrackerBotDrawing) {
-			DrawDebugString(GetWorld(), GetActorLocation(), "Target Reached");
-		}
-	} else {
+	// Waits at the path point until ASBotDecisions finds the next one
+	if (DistanceToTarget > RequiredDistanceToTarget) {
 		FVector ForceDirection = NextPathPoint - GetActorLocation();
 		ForceDirection.Normalize();
+		ForceDirection = (ForceDirection + Avoidance).GetClampedToMaxSize(1.f);
 		ForceDirection *= MovementForce;
 
 		MeshComp->AddForce(ForceDirection, NAME_None, bUseVelocityChange);
@@ -175,65 +465,50 @@ void ASTrackerBot::Tick(float DeltaTime)
 void ASTrackerBot::NotifyActorBeginOverlap(AActor* OtherActor) {
 	Super::NotifyActorBeginOverlap(OtherActor);
 
-	if (bStartedSelfDestruction || bExploded) { return; }
+	// The server decides this in ASBotDecisions, clients only play the warning
+	if (Role == ROLE_Authority || bStartedSelfDestruction || bExploded) { return; }
 	auto PlayerPawn = Cast<ASCharacter>(OtherActor);
 
 	if (PlayerPawn && !USHealthComponent::IsFriendly(OtherActor, this)) {
-		if (Role == ROLE_Authority) {
-			GetWorldTimerManager().SetTimer(TimerHandle_SelfDamage, this, &ASTrackerBot::DamageSelf, SelfDamageInterval, true, 0.f);
-		}
-		
-		bStartedSelfDestruction = true;
-		UGameplayStatics::SpawnSoundAttached(SelfDestructSound, RootComponent);
+		StartSelfDestruction();
 	}
 }
 
-void ASTrackerBot::DamageSelf() {
-	UGameplayStatics::ApplyDamage(this, 20, GetInstigatorController(), this, nullptr);
-}
-
-void ASTrackerBot::OnCheckNearbyBots() {
-	const float Radius = 600;
-
-	FCollisionShape CollShape;
-	CollShape.SetSphere(Radius);
-
-	FCollisionObjectQueryParams QueryParams;
-
-	QueryParams.AddObjectTypesToQuery(ECC_PhysicsBody);
-	QueryParams.AddObjectTypesToQuery(ECC_Pawn);
-
-	TArray<FOverlapResult> Overlaps;
-
-	GetWorld()->OverlapMultiByObjectType(Overlaps, GetActorLocation(), FQuat::Identity, QueryParams, CollShape);
+void ASTrackerBot::StartSelfDestruction() {
+	if (bStartedSelfDestruction || bExploded) { return; }
 
-	if (DebugTrackerBotDrawing) {
-		DrawDebugSphere(GetWorld(), GetActorLocation(), Radius, 12, FColor::White, false, 1.f);
+	if (Role == ROLE_Authority) {
+		GetWorldTimerManager().SetTimer(TimerHandle_SelfDamage, this, &ASTrackerBot::DamageSelf, SelfDamageInterval, true, 0.f);
 	}
 
-	int32 NrOfBots = 0;
+	bStartedSelfDestruction = true;
 
-	for (auto Result : Overlaps) {
-		auto Bot = Cast<ASTrackerBot>(Result.GetActor());
-		if (Bot && Bot != this) {
-			NrOfBots++;
-		}
+	if (GetNetMode() != NM_DedicatedServer) {
+		UGameplayStatics::SpawnSoundAttached(SelfDestructSound.Get(), RootComponent);
 	}
+}
 
-	const int32 MaxPowerLevel = 4;
+void ASTrackerBot::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	OutAssets.Add(ExplosionEffects.ToSoftObjectPath());
+	OutAssets.Add(SelfDestructSound.ToSoftObjectPath());
+	OutAssets.Add(ExplodeSound.ToSoftObjectPath());
+}
 
-	PowerLevel = FMath::Clamp(NrOfBots, 0, MaxPowerLevel);
-	
-	if (MatInst == nullptr) {
-		MatInst = MeshComp->CreateAndSetMaterialInstanceDynamicFromMaterial(0, MeshComp->GetMaterial(0));
-	}
+void ASTrackerBot::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	if (MatInst) {
-		float Alpha = PowerLevel / float(MaxPowerLevel);
-		MatInst->SetScalarParameterValue("PowerLevelAlpha", Alpha);
-	}
+	DOREPLIFETIME(ASTrackerBot, bPooled);
+	DOREPLIFETIME(ASTrackerBot, PowerLevel);
 }
 
-void ASTrackerBot::RefreshPath() {
-	NextPathPoint = GetNextPathPoint();
+void ASTrackerBot::DamageSelf() {
+	UGameplayStatics::ApplyDamage(this, 20, GetInstigatorController(), this, nullptr);
+}
+
+void ASTrackerBot::SetPowerLevel(int32 NewPowerLevel) {
+	if (NewPowerLevel == PowerLevel) { return; }
+
+	// Replicated so clients can show the power level glow
+	PowerLevel = NewPowerLevel;
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASTrackerBot, PowerLevel));
 }
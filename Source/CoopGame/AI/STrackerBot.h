@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "SPreloadable.h"
+#include "SBotDecisions.h"
 #include "STrackerBot.generated.h"
 
 class USphereComponent;
@@ -11,7 +14,7 @@ class USHealthComponent;
 class USoundCue;
 
 UCLASS()
-class COOPGAME_API ASTrackerBot : public APawn
+class COOPGAME_API ASTrackerBot : public APawn, public ISPreloadable
 {
 	GENERATED_BODY()
 
@@ -19,10 +22,61 @@ public:
 	// Sets default values for this pawn's properties
 	ASTrackerBot();
 
+	// Parks the bot in the game mode's pool instead of destroying it
+	virtual void Reset() override;
+
+	// Hidden, inert and waiting in the pool
+	void Deactivate();
+
+	// Brings a pooled bot back at the given transform with full health
+	void Reactivate(const FTransform& SpawnTransform);
+
+	bool IsPooled() const { return bPooled; }
+
+	bool HasExploded() const { return bExploded; }
+
+	int32 GetPowerLevel() const { return PowerLevel; }
+
+	// World time of the last hit, what the material pulses from
+	float GetLastTimeDamageTaken() const { return LastTimeDamageTaken; }
+
+	UStaticMeshComponent* GetMeshComp() const { return MeshComp; }
+
+	// Heap memory held by the reused path, for COOP.DumpMemory
+	SIZE_T GetPathAllocatedSize() const;
+
+	// Set by ASBotAvoidance each frame before the bot steers
+	void SetAvoidance(const FVector& InAvoidance) { Avoidance = InAvoidance; }
+
+	// Server side: what ASBotDecisions needs to decide for this bot
+	void GetDecisionInput(FSBotDecisionInput& OutInput) const;
+
+	// Server side: acts on this frame's decision from ASBotDecisions
+	void ApplyDecision(const FSBotDecision& Decision, APawn* Target);
+
+	static const int32 MaxPowerLevel = 4;
+
+	// Client side: a movement update from ASBotMovementReplicator, stamped with the server's world time
+	void ReceiveMovement(float ServerTime, const FVector& NewLocation, const FVector& NewVelocity);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	struct FMovementSnapshot {
+		float ServerTime;
+		FVector Location;
+		FVector Velocity;
+	};
+
+	// Latest movement updates received, oldest first
+	TArray<FMovementSnapshot, TInlineAllocator<4>> MovementSnapshots;
+
+	// Places the bot between the received updates, or past the latest one for a short while
+	void TickSimulatedMovement(float DeltaTime);
+
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
 	UStaticMeshComponent* MeshComp;
 
@@ -33,14 +87,20 @@ protected:
 	USphereComponent* SphereComp;
 
 
-	UFUNCTION()
 	void HandleTakeDamage(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
 		const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
 
-	FVector GetNextPathPoint();
+	// Next point on the navigation path to Target, or the bot's own location if there is no path
+	FVector FindNextPathPoint(APawn* Target);
+
+	// Refilled by every path query instead of allocating a new path per waypoint
+	FNavPathSharedPtr PathBuffer;
 
 	FVector NextPathPoint;
 
+	// Added to the direction toward NextPathPoint to keep clear of other bots
+	FVector Avoidance;
+
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
 	float MovementForce;
 
@@ -50,12 +110,15 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
 	float RequiredDistanceToTarget;
 
-	UMaterialInstanceDynamic* MatInst;
+	float LastTimeDamageTaken;
+
+	// Drawn by ASBotRenderer rather than by MeshComp
+	bool bInstanced;
 
 	void SelfDestruct();
 
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
-	UParticleSystem* ExplosionEffects;
+	TSoftObjectPtr<UParticleSystem> ExplosionEffects;
 
 	bool bExploded;
 
@@ -65,27 +128,47 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
 	float ExplosionDamage;
 
+	// Just the bot itself, kept for every explosion of the pooled bot
+	UPROPERTY(Transient)
+	TArray<AActor*> ExplosionIgnoredActors;
+
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
 	float SelfDamageInterval;
 
 	bool bStartedSelfDestruction;
 
 	FTimerHandle TimerHandle_SelfDamage;
-	FTimerHandle  TimerHandle_RefreshPath;
 
 	void DamageSelf();
 
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
-	USoundCue* SelfDestructSound;
+	TSoftObjectPtr<USoundCue> SelfDestructSound;
 
 	UPROPERTY(EditDefaultsOnly, Category = "TrackerBot")
-	USoundCue* ExplodeSound;
+	TSoftObjectPtr<USoundCue> ExplodeSound;
 
+	UPROPERTY(Replicated)
 	int32 PowerLevel;
 
-	void OnCheckNearbyBots();
+	void SetPowerLevel(int32 NewPowerLevel);
+
+	float LastPathTime;
 
-	void RefreshPath();
+	float NextPowerLevelCheckTime;
+
+	// Starts chasing players and checking for nearby bots
+	void StartTracking();
+
+	void StartSelfDestruction();
+	FTimerHandle TimerHandle_ReturnToPool;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Pooled)
+	bool bPooled;
+
+	UFUNCTION()
+	void OnRep_Pooled();
+
+	void ReturnToPool();
 
 
 public:	
@@ -93,4 +176,8 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
+
+	virtual void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const override;
 };
\ No newline at end of file
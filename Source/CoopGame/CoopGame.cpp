@@ -2,5 +2,23 @@
 
 #include "CoopGame.h"
 #include "Modules/ModuleManager.h"
+#include "SMemoryTags.h"
+#include "SMatchLog.h"
+#include "SNetStats.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, CoopGame, "CoopGame" );
+class FCoopGameModule : public FDefaultGameModuleImpl {
+public:
+	virtual void StartupModule() override {
+		RegisterMemoryTags();
+	}
+
+	virtual void ShutdownModule() override {
+		// Writes out what's still queued while the file system and threads are around
+		FSMatchLog::Get().Shutdown();
+		FSNetStats::Get().Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FCoopGameModule, CoopGame, "CoopGame" );
+
+DEFINE_LOG_CATEGORY(LogCoopGame);
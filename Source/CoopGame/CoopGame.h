@@ -3,7 +3,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
 #define SURFACE_FLESHDEFAULT SurfaceType1
 #define SURFACE_FLESHVULNERABLE SurfaceType2
-#define COLLISION_WEAPON ECC_GameTraceChannel1
\ No newline at end of file
+#define COLLISION_WEAPON ECC_GameTraceChannel1
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCoopGame, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("CoopGame"), STATGROUP_CoopGame, STATCAT_Advanced);
\ No newline at end of file
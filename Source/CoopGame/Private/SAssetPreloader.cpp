@@ -0,0 +1,80 @@
+#include "SAssetPreloader.h"
+#include "SPreloadable.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/Pawn.h"
+#include "EngineUtils.h"
+
+
+ASAssetPreloader::ASAssetPreloader() {
+	SetReplicates(false);
+}
+
+ASAssetPreloader* ASAssetPreloader::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_DedicatedServer) { return nullptr; }
+
+	return GetWorldManager<ASAssetPreloader>(World);
+}
+
+void ASAssetPreloader::PreloadClass(UClass* Class) {
+	if (!Class || Handles.Contains(Class)) { return; }
+	if (!Class->ImplementsInterface(USPreloadable::StaticClass())) { return; }
+
+	TArray<FSoftObjectPath> Assets;
+	Cast<ISPreloadable>(Class->GetDefaultObject())->GetPreloadAssets(Assets);
+	Assets.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+
+	TSharedPtr<FStreamableHandle> Handle;
+	if (Assets.Num() > 0) {
+		UE_LOG(LogCoopGame, Verbose, TEXT("Preloading %d asset(s) for %s"), Assets.Num(), *Class->GetName());
+		Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Assets, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	// Classes without assets are remembered too so they aren't collected again
+	Handles.Add(Class, Handle);
+}
+
+void ASAssetPreloader::PrepareForWave(const TArray<TSubclassOf<APawn>>& UpcomingBotClasses) {
+	TSet<UClass*> NeededClasses;
+
+	for (const TSubclassOf<APawn>& BotClass : UpcomingBotClasses) {
+		NeededClasses.Add(BotClass);
+	}
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It) {
+		if (It->GetClass()->ImplementsInterface(USPreloadable::StaticClass())) {
+			NeededClasses.Add(It->GetClass());
+		}
+	}
+	NeededClasses.Remove(nullptr);
+
+	// Release classes from earlier waves that nothing uses anymore
+	for (auto It = Handles.CreateIterator(); It; ++It) {
+		UClass* Class = It.Key().Get();
+		if (Class && NeededClasses.Contains(Class)) { continue; }
+
+		if (It.Value().IsValid()) {
+			UE_LOG(LogCoopGame, Verbose, TEXT("Releasing preloaded assets for %s"), Class ? *Class->GetName() : TEXT("<unloaded class>"));
+			It.Value()->ReleaseHandle();
+		}
+		It.RemoveCurrent();
+	}
+
+	for (UClass* Class : NeededClasses) {
+		PreloadClass(Class);
+	}
+}
+
+void ASAssetPreloader::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	for (auto& Pair : Handles) {
+		if (Pair.Value.IsValid()) {
+			Pair.Value->ReleaseHandle();
+		}
+	}
+	Handles.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
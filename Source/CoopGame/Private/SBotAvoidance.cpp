@@ -0,0 +1,218 @@
+#include "SBotAvoidance.h"
+#include "AI/STrackerBot.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bot Avoidance"), STAT_BotAvoidance, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Contacts"), STAT_BotContacts, STATGROUP_CoopGame);
+
+static int32 BotAvoidanceEnabled = 1;
+FAutoConsoleVariableRef CVARBotAvoidanceEnabled(
+	TEXT("COOP.BotAvoidance"),
+	BotAvoidanceEnabled,
+	TEXT("Steer tracker bots around each other. 0 leaves separation to physics"),
+	ECVF_Default);
+
+static float BotAvoidanceRadius = 100.f;
+FAutoConsoleVariableRef CVARBotAvoidanceRadius(
+	TEXT("COOP.BotAvoidanceRadius"),
+	BotAvoidanceRadius,
+	TEXT("Gap bots try to keep between each other, on top of their own radii"),
+	ECVF_Default);
+
+static float BotAvoidanceTimeHorizon = 0.5f;
+FAutoConsoleVariableRef CVARBotAvoidanceTimeHorizon(
+	TEXT("COOP.BotAvoidanceTimeHorizon"),
+	BotAvoidanceTimeHorizon,
+	TEXT("How far ahead bots look for collisions with each other, in seconds"),
+	ECVF_Default);
+
+static float BotAvoidanceWeight = 1.5f;
+FAutoConsoleVariableRef CVARBotAvoidanceWeight(
+	TEXT("COOP.BotAvoidanceWeight"),
+	BotAvoidanceWeight,
+	TEXT("Strength of avoidance relative to steering toward the path"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchBotAvoidanceCommand(
+	TEXT("COOP.BenchBotAvoidance"),
+	TEXT("Server only: log average frame time, avoidance time and bot contacts over the next frames. Optional argument: number of frames (default 300). Compare with COOP.BotAvoidance 0, using COOP.SpawnBots for density"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		auto Avoidance = ASBotAvoidance::Get(World);
+		if (!Avoidance) {
+			Ar.Log(TEXT("COOP.BenchBotAvoidance needs to run on the server"));
+			return;
+		}
+
+		const int32 NrOfFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300;
+		Avoidance->StartBenchmark(FMath::Max(NrOfFrames, 1));
+		Ar.Logf(TEXT("Sampling %d frames, results go to the log"), NrOfFrames);
+	}));
+
+ASBotAvoidance::ASBotAvoidance() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Bots tick after this, see ASTrackerBot::BeginPlay
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	SetReplicates(false);
+
+	BenchmarkFramesLeft = 0;
+}
+
+ASBotAvoidance* ASBotAvoidance::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client) { return nullptr; }
+
+	return GetWorldManager<ASBotAvoidance>(World);
+}
+
+void ASBotAvoidance::RegisterBot(ASTrackerBot* Bot) {
+	Bots.AddUnique(Bot);
+}
+
+void ASBotAvoidance::UnregisterBot(ASTrackerBot* Bot) {
+	Bots.RemoveSwap(Bot);
+}
+
+void ASBotAvoidance::StartBenchmark(int32 NrOfFrames) {
+	BenchmarkFramesLeft = NrOfFrames;
+	BenchmarkFrames = 0;
+	BenchmarkFrameTime = 0.0;
+	BenchmarkAvoidanceTime = 0.0;
+	BenchmarkBots = 0;
+	BenchmarkContacts = 0;
+}
+
+void ASBotAvoidance::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	COOP_LLM_SCOPE(ESMemoryTag::Bots);
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NrOfContacts = ComputeAvoidance();
+	const double AvoidanceTime = FPlatformTime::Seconds() - StartTime;
+
+	SET_DWORD_STAT(STAT_BotContacts, NrOfContacts);
+
+	if (BenchmarkFramesLeft <= 0) { return; }
+
+	BenchmarkFrames++;
+	BenchmarkFrameTime += DeltaSeconds;
+	BenchmarkAvoidanceTime += AvoidanceTime;
+	BenchmarkBots += ActiveBots.Num();
+	BenchmarkContacts += NrOfContacts;
+
+	if (--BenchmarkFramesLeft == 0) {
+		UE_LOG(LogCoopGame, Log, TEXT("Bot avoidance %s over %d frames: %.1f bots, %.1f contacts, frame %.2f ms, avoidance %.3f ms"),
+			BotAvoidanceEnabled ? TEXT("on") : TEXT("off"), BenchmarkFrames, BenchmarkBots / double(BenchmarkFrames), BenchmarkContacts / double(BenchmarkFrames),
+			BenchmarkFrameTime * 1000.0 / BenchmarkFrames, BenchmarkAvoidanceTime * 1000.0 / BenchmarkFrames);
+	}
+}
+
+int32 ASBotAvoidance::ComputeAvoidance() {
+	SCOPE_CYCLE_COUNTER(STAT_BotAvoidance);
+
+	Bots.RemoveAllSwap([](const TWeakObjectPtr<ASTrackerBot>& Bot) { return !Bot.IsValid(); });
+
+	ActiveBots.Reset();
+	Positions.Reset();
+	Velocities.Reset();
+	Radii.Reset();
+
+	float MaxRadius = 0.f;
+	float MaxSpeed = 0.f;
+
+	for (const TWeakObjectPtr<ASTrackerBot>& BotPtr : Bots) {
+		ASTrackerBot* Bot = BotPtr.Get();
+		if (Bot->IsPooled() || Bot->HasExploded()) { continue; }
+
+		const FVector Velocity = Bot->GetVelocity();
+		const float Radius = Bot->GetMeshComp()->Bounds.SphereRadius;
+
+		ActiveBots.Add(Bot);
+		Positions.Add(FVector2D(Bot->GetActorLocation()));
+		Velocities.Add(FVector2D(Velocity));
+		Radii.Add(Radius);
+
+		MaxRadius = FMath::Max(MaxRadius, Radius);
+		MaxSpeed = FMath::Max(MaxSpeed, Velocity.Size2D());
+	}
+
+	const int32 NrOfBots = ActiveBots.Num();
+	Avoidance.Reset();
+	Avoidance.AddZeroed(NrOfBots);
+
+	const float Horizon = FMath::Max(BotAvoidanceTimeHorizon, 0.f);
+	const float Gap = FMath::Max(BotAvoidanceRadius, 0.f);
+
+	// Large enough that every bot that could get within range inside the horizon is in a neighbouring cell
+	const float CellSize = FMath::Max(2.f * MaxRadius + Gap + 2.f * MaxSpeed * Horizon, 1.f);
+
+	CellHeads.Reset();
+	NextInCell.SetNumUninitialized(NrOfBots, false);
+
+	for (int32 Index = 0; Index < NrOfBots; ++Index) {
+		const FIntPoint Cell(FMath::FloorToInt(Positions[Index].X / CellSize), FMath::FloorToInt(Positions[Index].Y / CellSize));
+		const int32* Head = CellHeads.Find(Cell);
+		NextInCell[Index] = Head ? *Head : INDEX_NONE;
+		CellHeads.Add(Cell, Index);
+	}
+
+	int32 NrOfContacts = 0;
+
+	for (int32 Index = 0; Index < NrOfBots; ++Index) {
+		const FVector2D Position = Positions[Index];
+		const FVector2D Velocity = Velocities[Index];
+		const FIntPoint Cell(FMath::FloorToInt(Position.X / CellSize), FMath::FloorToInt(Position.Y / CellSize));
+
+		FVector2D Push = FVector2D::ZeroVector;
+
+		for (int32 CellY = Cell.Y - 1; CellY <= Cell.Y + 1; ++CellY) {
+			for (int32 CellX = Cell.X - 1; CellX <= Cell.X + 1; ++CellX) {
+				const int32* Head = CellHeads.Find(FIntPoint(CellX, CellY));
+
+				for (int32 Other = Head ? *Head : INDEX_NONE; Other != INDEX_NONE; Other = NextInCell[Other]) {
+					if (Other == Index) { continue; }
+
+					const FVector2D RelativePosition = Positions[Other] - Position;
+					const float ContactDistance = Radii[Index] + Radii[Other];
+
+					if (Other > Index && RelativePosition.SizeSquared() < FMath::Square(ContactDistance + 1.f)) {
+						NrOfContacts++;
+					}
+
+					// Where the two will be closest to each other within the horizon, assuming neither steers
+					const FVector2D RelativeVelocity = Velocities[Other] - Velocity;
+					const float RelativeSpeedSquared = RelativeVelocity.SizeSquared();
+					const float TimeToClosest = RelativeSpeedSquared > KINDA_SMALL_NUMBER
+						? FMath::Clamp(-FVector2D::DotProduct(RelativePosition, RelativeVelocity) / RelativeSpeedSquared, 0.f, Horizon)
+						: 0.f;
+					const FVector2D Closest = RelativePosition + RelativeVelocity * TimeToClosest;
+
+					const float Range = ContactDistance + Gap;
+					const float ClosestDistance = Closest.Size();
+					if (ClosestDistance >= Range) { continue; }
+
+					// Head-on: sidestep to the right so the two pick opposite sides
+					const FVector2D Away = ClosestDistance > KINDA_SMALL_NUMBER
+						? -Closest / ClosestDistance
+						: FVector2D(RelativePosition.Y, -RelativePosition.X).GetSafeNormal();
+
+					// Sooner and closer encounters push harder
+					const float Urgency = (1.f - ClosestDistance / Range) * (Horizon > 0.f ? 1.f - 0.5f * TimeToClosest / Horizon : 1.f);
+					Push += Away * Urgency;
+				}
+			}
+		}
+
+		Avoidance[Index] = Push.GetSafeNormal() * FMath::Min(Push.Size(), 1.f);
+	}
+
+	const float Weight = BotAvoidanceEnabled ? BotAvoidanceWeight : 0.f;
+	for (int32 Index = 0; Index < NrOfBots; ++Index) {
+		ActiveBots[Index]->SetAvoidance(FVector(Avoidance[Index] * Weight, 0.f));
+	}
+
+	return NrOfContacts;
+}
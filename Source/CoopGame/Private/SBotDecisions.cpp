@@ -0,0 +1,225 @@
+#include "SBotDecisions.h"
+#include "AI/STrackerBot.h"
+#include "SHealthComponent.h"
+#include "SCharacter.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Snapshot Bot Decisions"), STAT_SnapshotBotDecisions, STATGROUP_CoopGame);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Bot Decisions"), STAT_EvaluateBotDecisions, STATGROUP_CoopGame);
+DECLARE_CYCLE_STAT(TEXT("Commit Bot Decisions"), STAT_CommitBotDecisions, STATGROUP_CoopGame);
+
+static int32 BotDecisionParallelThreshold = 16;
+FAutoConsoleVariableRef CVARBotDecisionParallelThreshold(
+	TEXT("COOP.BotDecisionParallelThreshold"),
+	BotDecisionParallelThreshold,
+	TEXT("Minimum number of bots before their decisions are evaluated on worker threads while physics runs"),
+	ECVF_Default);
+
+static float BotPathRefreshInterval = 5.f;
+FAutoConsoleVariableRef CVARBotPathRefreshInterval(
+	TEXT("COOP.BotPathRefreshInterval"),
+	BotPathRefreshInterval,
+	TEXT("Seconds before a bot finds a new path to its target even if it hasn't reached the next path point"),
+	ECVF_Default);
+
+static float BotPowerLevelRadius = 600.f;
+FAutoConsoleVariableRef CVARBotPowerLevelRadius(
+	TEXT("COOP.BotPowerLevelRadius"),
+	BotPowerLevelRadius,
+	TEXT("Bots within this distance of each other raise each other's power level"),
+	ECVF_Default);
+
+void FSBotDecisionCommitTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) {
+	if (Target && !Target->IsPendingKill()) {
+		Target->CommitDecisions();
+	}
+}
+
+FString FSBotDecisionCommitTickFunction::DiagnosticMessage() {
+	return TEXT("FSBotDecisionCommitTickFunction");
+}
+
+ASBotDecisions::ASBotDecisions() {
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	CommitTick.bCanEverTick = true;
+	CommitTick.TickGroup = TG_PostPhysics;
+	CommitTick.Target = nullptr;
+
+	SetReplicates(false);
+}
+
+ASBotDecisions* ASBotDecisions::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client) { return nullptr; }
+
+	return GetWorldManager<ASBotDecisions>(World);
+}
+
+void ASBotDecisions::RegisterActorTickFunctions(bool bRegister) {
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister) {
+		CommitTick.Target = this;
+		CommitTick.RegisterTickFunction(GetLevel());
+		CommitTick.AddPrerequisite(this, PrimaryActorTick);
+	} else if (CommitTick.IsTickFunctionRegistered()) {
+		CommitTick.UnRegisterTickFunction();
+	}
+}
+
+void ASBotDecisions::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	// The workers read arrays owned by this actor
+	if (EvaluateTask.IsValid()) {
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(EvaluateTask, ENamedThreads::GameThread);
+		EvaluateTask = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASBotDecisions::RegisterBot(ASTrackerBot* Bot) {
+	Bots.AddUnique(Bot);
+}
+
+void ASBotDecisions::UnregisterBot(ASTrackerBot* Bot) {
+	// Not RemoveSwap, the order is what keeps the commit deterministic
+	Bots.Remove(Bot);
+}
+
+void ASBotDecisions::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	COOP_LLM_SCOPE(ESMemoryTag::Bots);
+	Snapshot();
+
+	const int32 NrOfBots = Inputs.Num();
+	if (NrOfBots == 0) { return; }
+
+	if (NrOfBots < BotDecisionParallelThreshold) {
+		for (int32 Index = 0; Index < NrOfBots; ++Index) {
+			EvaluateBot(Index);
+		}
+		return;
+	}
+
+	EvaluateTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this, NrOfBots]() {
+		SCOPE_CYCLE_COUNTER(STAT_EvaluateBotDecisions);
+
+		ParallelFor(NrOfBots, [this](int32 Index) {
+			EvaluateBot(Index);
+		});
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+}
+
+void ASBotDecisions::Snapshot() {
+	SCOPE_CYCLE_COUNTER(STAT_SnapshotBotDecisions);
+
+	Bots.RemoveAll([](const TWeakObjectPtr<ASTrackerBot>& Bot) { return !Bot.IsValid(); });
+
+	SnapshotBots.Reset();
+	Inputs.Reset();
+
+	for (const TWeakObjectPtr<ASTrackerBot>& BotPtr : Bots) {
+		ASTrackerBot* Bot = BotPtr.Get();
+		if (Bot->IsPooled() || Bot->HasExploded()) { continue; }
+
+		SnapshotBots.Add(Bot);
+		Inputs.AddDefaulted();
+		Bot->GetDecisionInput(Inputs.Last());
+	}
+
+	SnapshotTargets.Reset();
+	Targets.Reset();
+
+	for (auto It = GetWorld()->GetPawnIterator(); It; ++It) {
+		APawn* Pawn = It->Get();
+		if (!Pawn || Pawn->IsA<ASTrackerBot>()) { continue; }
+
+		auto HealthComp = Cast<USHealthComponent>(Pawn->GetComponentByClass(USHealthComponent::StaticClass()));
+		if (!HealthComp || HealthComp->GetHealth() <= 0.f) { continue; }
+
+		FSBotDecisionTarget& Target = Targets[Targets.AddDefaulted()];
+		Target.Location = Pawn->GetActorLocation();
+		Pawn->GetSimpleCollisionCylinder(Target.Radius, Target.HalfHeight);
+		Target.TeamNum = HealthComp->TeamNum;
+		Target.bTriggersSelfDestruct = Pawn->IsA<ASCharacter>();
+
+		SnapshotTargets.Add(Pawn);
+	}
+
+	Decisions.Reset();
+	Decisions.SetNum(Inputs.Num());
+}
+
+void ASBotDecisions::EvaluateBot(int32 Index) {
+	const FSBotDecisionInput& Input = Inputs[Index];
+	FSBotDecision& Decision = Decisions[Index];
+
+	// Nearest hostile, ties go to the first in the snapshot
+	float NearestDistanceSquared = FLT_MAX;
+
+	for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex) {
+		const FSBotDecisionTarget& Target = Targets[TargetIndex];
+		if (Target.TeamNum == Input.TeamNum) { continue; }
+
+		const FVector Delta = Target.Location - Input.Location;
+		const float DistanceSquared = Delta.SizeSquared();
+		if (DistanceSquared < NearestDistanceSquared) {
+			NearestDistanceSquared = DistanceSquared;
+			Decision.Target = TargetIndex;
+		}
+
+		// Same test as the sphere overlapping the player's capsule: distance to the capsule's core segment against both radii
+		if (Input.bCanSelfDestruct && Target.bTriggersSelfDestruct) {
+			const float SegmentHalfLength = FMath::Max(Target.HalfHeight - Target.Radius, 0.f);
+			const FVector ClosestOnSegment(0.f, 0.f, FMath::Clamp(-Delta.Z, -SegmentHalfLength, SegmentHalfLength));
+			const float OverlapDistance = Input.SelfDestructRadius + Target.Radius;
+
+			if (FVector::DistSquared(-Delta, ClosestOnSegment) <= FMath::Square(OverlapDistance)) {
+				Decision.bSelfDestruct = true;
+			}
+		}
+	}
+
+	const bool bReachedPathPoint = FVector::DistSquared(Input.Location, Input.NextPathPoint) <= FMath::Square(Input.RequiredDistanceToTarget);
+	Decision.bRefreshPath = Decision.Target != INDEX_NONE && (bReachedPathPoint || Input.TimeSinceLastPath >= BotPathRefreshInterval);
+
+	if (Input.bCheckPowerLevel) {
+		int32 NrOfBots = 0;
+
+		for (int32 OtherIndex = 0; OtherIndex < Inputs.Num(); ++OtherIndex) {
+			const FSBotDecisionInput& Other = Inputs[OtherIndex];
+			if (OtherIndex != Index && FVector::DistSquared(Input.Location, Other.Location) <= FMath::Square(BotPowerLevelRadius + Other.Radius)) {
+				NrOfBots++;
+			}
+		}
+
+		Decision.PowerLevel = FMath::Min(NrOfBots, ASTrackerBot::MaxPowerLevel);
+	}
+}
+
+void ASBotDecisions::CommitDecisions() {
+	if (EvaluateTask.IsValid()) {
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(EvaluateTask, ENamedThreads::GameThread);
+		EvaluateTask = nullptr;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CommitBotDecisions);
+
+	for (int32 Index = 0; Index < SnapshotBots.Num(); ++Index) {
+		ASTrackerBot* Bot = SnapshotBots[Index].Get();
+		if (!Bot || Bot->IsPooled() || Bot->HasExploded()) { continue; }
+
+		const FSBotDecision& Decision = Decisions[Index];
+		APawn* Target = Decision.Target != INDEX_NONE ? SnapshotTargets[Decision.Target].Get() : nullptr;
+
+		Bot->ApplyDecision(Decision, Target);
+	}
+
+	SnapshotBots.Reset();
+}
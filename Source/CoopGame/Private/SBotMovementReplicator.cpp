@@ -0,0 +1,146 @@
+#include "SBotMovementReplicator.h"
+#include "AI/STrackerBot.h"
+#include "SPlayerState.h"
+#include "SWorldManager.h"
+#include "SNetStats.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Replicate Bot Movement"), STAT_ReplicateBotMovement, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Movement Updates"), STAT_BotMovementUpdates, STATGROUP_CoopGame);
+
+static float BotMovementNearRate = 20.f;
+FAutoConsoleVariableRef CVARBotMovementNearRate(
+	TEXT("COOP.BotMovementNearRate"),
+	BotMovementNearRate,
+	TEXT("Movement updates per second sent for a bot right next to a player"),
+	ECVF_Default);
+
+static float BotMovementFarRate = 4.f;
+FAutoConsoleVariableRef CVARBotMovementFarRate(
+	TEXT("COOP.BotMovementFarRate"),
+	BotMovementFarRate,
+	TEXT("Movement updates per second sent for a bot at COOP.BotMovementFarDistance or further from a player"),
+	ECVF_Default);
+
+static float BotMovementFarDistance = 5000.f;
+FAutoConsoleVariableRef CVARBotMovementFarDistance(
+	TEXT("COOP.BotMovementFarDistance"),
+	BotMovementFarDistance,
+	TEXT("Distance at which bot movement updates drop to COOP.BotMovementFarRate"),
+	ECVF_Default);
+
+ASBotMovementReplicator::ASBotMovementReplicator() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Send the positions physics just produced
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	SetReplicates(false);
+}
+
+ASBotMovementReplicator* ASBotMovementReplicator::Get(UWorld* World) {
+	if (!World) { return nullptr; }
+
+	const ENetMode NetMode = World->GetNetMode();
+	if (NetMode != NM_DedicatedServer && NetMode != NM_ListenServer) { return nullptr; }
+
+	return GetWorldManager<ASBotMovementReplicator>(World);
+}
+
+void ASBotMovementReplicator::RegisterBot(ASTrackerBot* Bot) {
+	Bots.AddUnique(Bot);
+}
+
+void ASBotMovementReplicator::UnregisterBot(ASTrackerBot* Bot) {
+	Bots.RemoveSwap(Bot);
+}
+
+void ASBotMovementReplicator::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_ReplicateBotMovement);
+	COOP_LLM_SCOPE(ESMemoryTag::Replication);
+
+	Bots.RemoveAllSwap([](const TWeakObjectPtr<ASTrackerBot>& Bot) { return !Bot.IsValid(); });
+
+	for (auto It = Clients.CreateIterator(); It; ++It) {
+		if (!It.Key().IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+
+	const float Now = GetWorld()->TimeSeconds;
+
+	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		APlayerController* PC = It->Get();
+
+		// The listen server's own player sees the authoritative bots
+		if (!PC || PC->IsLocalController()) { continue; }
+
+		ReplicateTo(PC, Clients.FindOrAdd(PC), Now);
+	}
+}
+
+void ASBotMovementReplicator::ReplicateTo(APlayerController* PC, FClientState& Client, float Now) {
+	auto PS = Cast<ASPlayerState>(PC->PlayerState);
+	auto Connection = PC->GetNetConnection();
+	if (!PS || !Connection) { return; }
+
+	// Forget bots that have been destroyed since
+	if (Client.Bots.Num() > Bots.Num() * 2) {
+		for (auto It = Client.Bots.CreateIterator(); It; ++It) {
+			if (!It.Key().IsValid()) {
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const float NearRate = FMath::Max(BotMovementNearRate, 0.1f);
+	const float FarRate = FMath::Max(BotMovementFarRate, 0.1f);
+	const float FarDistance = FMath::Max(BotMovementFarDistance, 1.f);
+
+	PendingUpdates.Reset();
+
+	for (const TWeakObjectPtr<ASTrackerBot>& BotPtr : Bots) {
+		ASTrackerBot* Bot = BotPtr.Get();
+		if (!Bot || Bot->IsPooled()) { continue; }
+
+		// Not relevant to this client, it couldn't resolve the bot
+		if (!Connection->ActorChannels.Contains(Bot)) { continue; }
+
+		FBotSendState& State = Client.Bots.FindOrAdd(Bot);
+		if (Now < State.NextSendTime) { continue; }
+
+		const FVector Location = Bot->GetActorLocation();
+		const FVector Velocity = Bot->GetVelocity();
+		const bool bMoving = !Velocity.IsNearlyZero(1.f) || !Location.Equals(State.LastSentLocation, 1.f);
+
+		// A resting bot only needs its final position sent once
+		if (!bMoving && !State.bWasMoving) { continue; }
+
+		const float DistanceAlpha = FMath::Clamp(FVector::Dist(ViewLocation, Location) / FarDistance, 0.f, 1.f);
+		State.NextSendTime = Now + 1.f / FMath::Lerp(NearRate, FarRate, DistanceAlpha);
+		State.LastSentLocation = Location;
+		State.bWasMoving = bMoving;
+
+		FSBotMovementUpdate Update;
+		Update.Bot = Bot;
+		Update.Location = Location;
+		Update.Velocity = Velocity;
+		PendingUpdates.Add(Update);
+	}
+
+	if (PendingUpdates.Num() == 0) { return; }
+
+	INC_DWORD_STAT_BY(STAT_BotMovementUpdates, PendingUpdates.Num());
+
+	PS->ClientReceiveBotMovement(Now, PendingUpdates);
+	FSNetStats::Get().RecordRPCSent(PS, GET_FUNCTION_NAME_CHECKED(ASPlayerState, ClientReceiveBotMovement), 32 + PendingUpdates.Num() * FSBotMovementUpdate::ApproxBits);
+}
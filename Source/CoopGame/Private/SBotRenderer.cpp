@@ -0,0 +1,193 @@
+#include "SBotRenderer.h"
+#include "AI/STrackerBot.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Bot Instances"), STAT_UpdateBotInstances, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Instances"), STAT_BotInstances, STATGROUP_CoopGame);
+
+static float BotPulseDuration = 0.5f;
+FAutoConsoleVariableRef CVARBotPulseDuration(
+	TEXT("COOP.BotPulseDuration"),
+	BotPulseDuration,
+	TEXT("How long a bot is drawn with the pulsing material after a hit, in seconds"),
+	ECVF_Default);
+
+int32 FSInstanceSlots::Add() {
+	const int32 Handle = FreeHandles.Num() > 0 ? FreeHandles.Pop(false) : HandleToIndex.AddUninitialized();
+	HandleToIndex[Handle] = IndexToHandle.Add(Handle);
+	return Handle;
+}
+
+int32 FSInstanceSlots::Remove(int32 Handle) {
+	const int32 Index = GetIndex(Handle);
+	if (Index == INDEX_NONE) { return INDEX_NONE; }
+
+	HandleToIndex[Handle] = INDEX_NONE;
+	FreeHandles.Add(Handle);
+
+	const int32 LastHandle = IndexToHandle.Pop(false);
+	if (LastHandle == Handle) { return INDEX_NONE; }
+
+	IndexToHandle[Index] = LastHandle;
+	HandleToIndex[LastHandle] = Index;
+	return Index;
+}
+
+ASBotRenderer::ASBotRenderer() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Pick up the bots after physics and client interpolation have moved them
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	SetReplicates(false);
+}
+
+ASBotRenderer* ASBotRenderer::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_DedicatedServer) { return nullptr; }
+
+	return GetWorldManager<ASBotRenderer>(World);
+}
+
+bool ASBotRenderer::RegisterBot(ASTrackerBot* Bot) {
+	if (!Bot || !Bot->GetMeshComp()->GetStaticMesh()) { return false; }
+
+	Bots.FindOrAdd(Bot);
+	return true;
+}
+
+void ASBotRenderer::UnregisterBot(ASTrackerBot* Bot) {
+	if (FBotEntry* Entry = Bots.Find(Bot)) {
+		RemoveInstance(*Entry);
+		Bots.Remove(Bot);
+	}
+}
+
+void ASBotRenderer::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_UpdateBotInstances);
+	COOP_LLM_SCOPE(ESMemoryTag::Bots);
+
+	const float Now = GetWorld()->TimeSeconds;
+	int32 NrOfInstances = 0;
+
+	for (auto It = Bots.CreateIterator(); It; ++It) {
+		ASTrackerBot* Bot = It.Key().Get();
+		FBotEntry& Entry = It.Value();
+
+		if (!Bot) {
+			RemoveInstance(Entry);
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (Bot->IsPooled() || Bot->HasExploded()) {
+			RemoveInstance(Entry);
+			continue;
+		}
+
+		auto MeshComp = Bot->GetMeshComp();
+		const FTransform& Transform = MeshComp->GetComponentTransform();
+
+		FBucketKey Key;
+		Key.Mesh = MeshComp->GetStaticMesh();
+		Key.Material = MeshComp->GetMaterial(0);
+		Key.PowerLevel = Bot->GetPowerLevel();
+		Key.bPulsing = Now - Bot->GetLastTimeDamageTaken() < BotPulseDuration;
+
+		const int32 BucketIndex = FindOrAddBucket(Key);
+		FBucket& Bucket = Buckets[BucketIndex];
+
+		if (Entry.Bucket != BucketIndex) {
+			RemoveInstance(Entry);
+			AddInstance(Entry, BucketIndex, Transform);
+		} else if (!Transform.Equals(Entry.LastTransform)) {
+			// The render state is rebuilt once per bucket below, not per instance
+			Bucket.Instances->UpdateInstanceTransform(Bucket.Slots.GetIndex(Entry.Handle), Transform, true, false, true);
+			Entry.LastTransform = Transform;
+			Bucket.bDirty = true;
+		}
+
+		if (Key.bPulsing && Bot->GetLastTimeDamageTaken() > Bucket.LastTimeDamageTaken && Bucket.Material) {
+			Bucket.LastTimeDamageTaken = Bot->GetLastTimeDamageTaken();
+			Bucket.Material->SetScalarParameterValue("LastTimeDamageTaken", Bucket.LastTimeDamageTaken);
+		}
+
+		NrOfInstances++;
+	}
+
+	for (FBucket& Bucket : Buckets) {
+		if (Bucket.bDirty) {
+			Bucket.Instances->MarkRenderStateDirty();
+			Bucket.bDirty = false;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_BotInstances, NrOfInstances);
+}
+
+int32 ASBotRenderer::FindOrAddBucket(const FBucketKey& Key) {
+	if (const int32* Found = BucketIndices.Find(Key)) {
+		return *Found;
+	}
+
+	FBucket Bucket;
+	Bucket.LastTimeDamageTaken = -BIG_NUMBER;
+	Bucket.bDirty = false;
+
+	Bucket.Instances = NewObject<UInstancedStaticMeshComponent>(this);
+	Bucket.Instances->SetMobility(EComponentMobility::Movable);
+	Bucket.Instances->SetStaticMesh(Key.Mesh);
+	Bucket.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bucket.Instances->SetCanEverAffectNavigation(false);
+
+	// The material has to be flagged for use with instanced static meshes
+	Bucket.Material = Key.Material ? UMaterialInstanceDynamic::Create(Key.Material, this) : nullptr;
+	if (Bucket.Material) {
+		Bucket.Material->SetScalarParameterValue("PowerLevelAlpha", Key.PowerLevel / float(ASTrackerBot::MaxPowerLevel));
+		Bucket.Instances->SetMaterial(0, Bucket.Material);
+	}
+
+	Bucket.Instances->RegisterComponent();
+
+	BucketObjects.Add(Bucket.Instances);
+	BucketObjects.Add(Bucket.Material);
+
+	const int32 BucketIndex = Buckets.Add(Bucket);
+	BucketIndices.Add(Key, BucketIndex);
+	return BucketIndex;
+}
+
+void ASBotRenderer::AddInstance(FBotEntry& Entry, int32 BucketIndex, const FTransform& Transform) {
+	FBucket& Bucket = Buckets[BucketIndex];
+
+	Entry.Bucket = BucketIndex;
+	Entry.Handle = Bucket.Slots.Add();
+	Entry.LastTransform = Transform;
+
+	Bucket.Instances->AddInstanceWorldSpace(Transform);
+}
+
+void ASBotRenderer::RemoveInstance(FBotEntry& Entry) {
+	if (Entry.Bucket == INDEX_NONE) { return; }
+
+	FBucket& Bucket = Buckets[Entry.Bucket];
+
+	// Fill the hole with the last instance so removing it doesn't shift the others
+	const int32 Hole = Bucket.Slots.Remove(Entry.Handle);
+	const int32 LastIndex = Bucket.Slots.Num();
+	if (Hole != INDEX_NONE) {
+		FTransform LastTransform;
+		Bucket.Instances->GetInstanceTransform(LastIndex, LastTransform, true);
+		Bucket.Instances->UpdateInstanceTransform(Hole, LastTransform, true, false, true);
+	}
+	Bucket.Instances->RemoveInstance(LastIndex);
+
+	Entry.Bucket = INDEX_NONE;
+	Entry.Handle = INDEX_NONE;
+}
@@ -10,7 +10,12 @@
 #include "Components/CapsuleComponent.h"
 #include "CoopGame.h"
 #include "SHealthComponent.h"
+#include "SEffectStackComponent.h"
 #include "UnrealNetwork.h"
+#include "SNetStats.h"
+#include "SHitboxRegistry.h"
+#include "SMemoryTags.h"
+#include "SCorpseManager.h"
 
 
 // Sets default values
@@ -19,22 +24,34 @@ ASCharacter::ASCharacter()
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Cameras are cosmetic, the dedicated server build never creates them
+#if !UE_SERVER
 	SpringArmComp = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArmComp"));
 	SpringArmComp->SetupAttachment(RootComponent);
 	SpringArmComp->bUsePawnControlRotation = true;
 
 	CameraComp = CreateDefaultSubobject<UCameraComponent>(TEXT("CameraComp"));
 	CameraComp->SetupAttachment(SpringArmComp);
+#endif
 
 	GetMovementComponent()->GetNavAgentPropertiesRef().bCanCrouch = true;
 	GetCapsuleComponent()->SetCollisionResponseToChannel(COLLISION_WEAPON, ECR_Ignore);
 
 	HealthComp = CreateDefaultSubobject<USHealthComponent>(TEXT("HealthComp"));
+	EffectsComp = CreateDefaultSubobject<USEffectStackComponent>(TEXT("EffectsComp"));
 
 	ZoomedFOV = 65.f;
 	ZoomInterpSpeed = 20.f;
 	WeaponAttachSocketName = "WeaponSocket";
 	bDied = false;
+
+	HeadHitboxSocket = "head";
+	HeadHitboxRadius = 15.f;
+	BodyHitboxBottomSocket = "pelvis";
+	BodyHitboxTopSocket = "neck_01";
+	BodyHitboxRadius = 25.f;
+
+	CorpseLifeSpan = 10.f;
 }
 
 FVector ASCharacter::GetPawnViewLocation() const {
@@ -46,16 +63,34 @@ FVector ASCharacter::GetPawnViewLocation() const {
 // Called when the game starts or when spawned
 void ASCharacter::BeginPlay()
 {
+	COOP_LLM_SCOPE(ESMemoryTag::Characters);
 	Super::BeginPlay();
 
-	DefaultFOV = CameraComp->FieldOfView;
-	HealthComp->OnHealthChanged.AddDynamic(this, &ASCharacter::OnHealthChanged);
+	if (CameraComp) {
+		DefaultFOV = CameraComp->FieldOfView;
+	}
+
+	// Zoom is the only thing we tick for
+	if (!CameraComp || GetNetMode() == NM_DedicatedServer) {
+		SetActorTickEnabled(false);
+	}
+
+	HealthComp->OnHealthChangedNative.AddUObject(this, &ASCharacter::OnHealthChanged);
+
+	if (auto Hitboxes = ASHitboxRegistry::Get(GetWorld())) {
+		Hitboxes->AddHitbox(GetMesh(), HeadHitboxSocket, HeadHitboxSocket, HeadHitboxRadius, SURFACE_FLESHVULNERABLE);
+		Hitboxes->AddHitbox(GetMesh(), BodyHitboxBottomSocket, BodyHitboxTopSocket, BodyHitboxRadius, SURFACE_FLESHDEFAULT);
+	}
 
 	if (Role == ROLE_Authority) {
+		COOP_LLM_SCOPE(ESMemoryTag::Weapons);
+
 		FActorSpawnParameters SpawnParams;
 		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
 		CurrentWeapon = GetWorld()->SpawnActor<ASWeapon>(StarterWeaponClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASCharacter, CurrentWeapon));
+		ForceNetUpdate();
 
 		if (CurrentWeapon) {
 			CurrentWeapon->SetOwner(this);
@@ -64,6 +99,14 @@ void ASCharacter::BeginPlay()
 	}
 }
 
+void ASCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (auto Hitboxes = ASHitboxRegistry::Get(GetWorld())) {
+		Hitboxes->RemoveHitboxes(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ASCharacter::StartFire() {
 	if (CurrentWeapon) {
 		CurrentWeapon->StartFire();
@@ -76,15 +119,31 @@ void ASCharacter::StopFire() {
 	}
 }
 
+void ASCharacter::Destroyed() {
+	if (HasAuthority() && CurrentWeapon) {
+		CurrentWeapon->Destroy();
+	}
+
+	Super::Destroyed();
+}
+
 void ASCharacter::OnHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
 	const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
 	if (Health <= 0.f && !bDied) {
 		bDied = true;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASCharacter, bDied));
+		ForceNetUpdate();
 
 		GetMovementComponent()->StopMovementImmediately();
 		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		DetachFromControllerPendingDestroy();
-		SetLifeSpan(10.f);
+		EffectsComp->ClearEffects();
+
+		if (auto Corpses = ASCorpseManager::Get(GetWorld())) {
+			Corpses->AddCorpse(this, CorpseLifeSpan);
+		} else {
+			SetLifeSpan(CorpseLifeSpan);
+		}
 	}
 }
 
@@ -93,6 +152,8 @@ void ASCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (!IsLocallyControlled()) { return; }
+
 	float TargetFOV = bWantsToZoom ? ZoomedFOV : DefaultFOV;
 	float NewFOV = FMath::FInterpTo(CameraComp->FieldOfView, TargetFOV, DeltaTime, ZoomInterpSpeed);
 
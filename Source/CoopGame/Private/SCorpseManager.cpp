@@ -0,0 +1,121 @@
+#include "SCorpseManager.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corpses"), STAT_Corpses, STATGROUP_CoopGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Corpses Recycled Early"), STAT_CorpsesRecycledEarly, STATGROUP_CoopGame);
+
+static int32 MaxCorpses = 16;
+FAutoConsoleVariableRef CVARMaxCorpses(
+	TEXT("COOP.MaxCorpses"),
+	MaxCorpses,
+	TEXT("Most dead characters and exploded bots kept at once, the oldest are recycled early beyond this"),
+	ECVF_Default);
+
+ASCorpseManager::ASCorpseManager() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Lifespans don't need to be exact
+	PrimaryActorTick.TickInterval = 0.25f;
+
+	SetReplicates(false);
+}
+
+ASCorpseManager* ASCorpseManager::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client) { return nullptr; }
+
+	return GetWorldManager<ASCorpseManager>(World);
+}
+
+void ASCorpseManager::AddCorpse(AActor* Corpse, float LifeSpan, const FSimpleDelegate& Recycle) {
+	if (!Corpse) { return; }
+
+	RemoveCorpse(Corpse);
+	Freeze(Corpse);
+
+	FCorpse& Entry = Corpses[Corpses.AddDefaulted()];
+	Entry.Actor = Corpse;
+	Entry.ExpireTime = GetWorld()->TimeSeconds + LifeSpan;
+	Entry.Recycle = Recycle;
+
+	while (Corpses.Num() > FMath::Max(MaxCorpses, 0)) {
+		INC_DWORD_STAT(STAT_CorpsesRecycledEarly);
+		RecycleCorpse(0);
+	}
+}
+
+void ASCorpseManager::RemoveCorpse(AActor* Corpse) {
+	Corpses.RemoveAll([Corpse](const FCorpse& Entry) { return Entry.Actor == Corpse; });
+}
+
+void ASCorpseManager::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	const float Now = GetWorld()->TimeSeconds;
+
+	// Sorted by when they were added, which for equal lifespans is also when they expire
+	for (int32 Index = 0; Index < Corpses.Num();) {
+		if (!Corpses[Index].Actor.IsValid()) {
+			Corpses.RemoveAt(Index, 1, false);
+		} else if (Corpses[Index].ExpireTime <= Now) {
+			RecycleCorpse(Index);
+		} else {
+			++Index;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_Corpses, Corpses.Num());
+}
+
+void ASCorpseManager::RecycleCorpse(int32 Index) {
+	// Off the list before recycling, which may call RemoveCorpse
+	FCorpse Entry = Corpses[Index];
+	Corpses.RemoveAt(Index, 1, false);
+
+	AActor* Corpse = Entry.Actor.Get();
+	if (!Corpse) { return; }
+
+	if (Entry.Recycle.IsBound()) {
+		Entry.Recycle.Execute();
+	} else {
+		Corpse->Destroy();
+	}
+}
+
+void ASCorpseManager::Freeze(AActor* Actor) {
+	if (!Actor) { return; }
+
+	// A listen server's host still watches the death animation play out
+	const bool bKeepAnimation = Actor->GetNetMode() != NM_DedicatedServer;
+
+	Actor->SetActorTickEnabled(false);
+
+	TInlineComponentArray<UActorComponent*> Components;
+	Actor->GetComponents(Components);
+
+	for (UActorComponent* Component : Components) {
+		if (bKeepAnimation && Component->IsA<USkeletalMeshComponent>()) { continue; }
+
+		Component->SetComponentTickEnabled(false);
+
+		auto Primitive = Cast<UPrimitiveComponent>(Component);
+		if (Primitive && Primitive->IsSimulatingPhysics()) {
+			Primitive->SetSimulatePhysics(false);
+		}
+	}
+
+	// Goes dormant once the current state has been sent
+	if (Actor->GetIsReplicated()) {
+		Actor->SetNetDormancy(DORM_DormantAll);
+		Actor->ForceNetUpdate();
+	}
+
+	TArray<AActor*> AttachedActors;
+	Actor->GetAttachedActors(AttachedActors);
+
+	for (AActor* Attached : AttachedActors) {
+		Freeze(Attached);
+	}
+}
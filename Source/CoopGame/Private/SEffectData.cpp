@@ -0,0 +1,10 @@
+#include "SEffectData.h"
+
+
+USEffectData::USEffectData() {
+	Kind = ESEffectKind::HealOverTime;
+	Magnitude = 20.f;
+	Duration = 5.f;
+	TickInterval = 1.f;
+	PickupMesh = nullptr;
+}
@@ -0,0 +1,44 @@
+#include "SEffectProcessor.h"
+#include "SEffectStackComponent.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Process Effects"), STAT_ProcessEffects, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Stacks"), STAT_EffectStacks, STATGROUP_CoopGame);
+
+ASEffectProcessor::ASEffectProcessor() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Heals go out with the rest of the frame's health changes
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	SetReplicates(false);
+}
+
+ASEffectProcessor* ASEffectProcessor::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client) { return nullptr; }
+
+	return GetWorldManager<ASEffectProcessor>(World);
+}
+
+void ASEffectProcessor::RegisterStack(USEffectStackComponent* EffectStack) {
+	Stacks.AddUnique(EffectStack);
+}
+
+void ASEffectProcessor::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_ProcessEffects);
+
+	const float Now = GetWorld()->TimeSeconds;
+
+	for (int32 Index = Stacks.Num() - 1; Index >= 0; --Index) {
+		USEffectStackComponent* EffectStack = Stacks[Index].Get();
+
+		if (!EffectStack || !EffectStack->ProcessEffects(Now)) {
+			Stacks.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_EffectStacks, Stacks.Num());
+}
@@ -0,0 +1,156 @@
+#include "SEffectStackComponent.h"
+#include "SEffectData.h"
+#include "SEffectProcessor.h"
+#include "SHealthComponent.h"
+#include "SNetStats.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "UnrealNetwork.h"
+
+USEffectStackComponent::USEffectStackComponent() {
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicated(true);
+
+	DamageMultiplier = 1.f;
+	BaseMaxWalkSpeed = 0.f;
+}
+
+void USEffectStackComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	HealthComp = GetOwner()->FindComponentByClass<USHealthComponent>();
+	MovementComp = GetOwner()->FindComponentByClass<UCharacterMovementComponent>();
+
+	if (MovementComp) {
+		BaseMaxWalkSpeed = MovementComp->MaxWalkSpeed;
+	}
+
+	// Effects that replicated before the owner began play
+	if (ActiveEffects.Num() > 0) {
+		UpdateModifiers();
+	}
+}
+
+float USEffectStackComponent::GetDamageMultiplier(const AActor* Actor) {
+	auto EffectStack = Actor ? Actor->FindComponentByClass<USEffectStackComponent>() : nullptr;
+	return EffectStack ? EffectStack->GetDamageMultiplier() : 1.f;
+}
+
+bool USEffectStackComponent::HasEffect(const USEffectData* Effect) const {
+	return ActiveEffects.ContainsByPredicate([Effect](const FSActiveEffect& Active) { return Active.Effect == Effect; });
+}
+
+void USEffectStackComponent::ApplyEffect(USEffectData* Effect) {
+	if (!Effect || GetOwnerRole() != ROLE_Authority) { return; }
+
+	const float Now = GetWorld()->TimeSeconds;
+
+	FSActiveEffect* Active = ActiveEffects.FindByPredicate([Effect](const FSActiveEffect& Entry) { return Entry.Effect == Effect; });
+	if (!Active) {
+		Active = &ActiveEffects[ActiveEffects.AddDefaulted()];
+		Active->Effect = Effect;
+	}
+
+	// Same timing as the Blueprint powerups: instant without an interval, otherwise the first heal one interval in
+	Active->EndTime = Now + Effect->Duration;
+	Active->NextTickTime = Effect->TickInterval > 0.f ? Now + Effect->TickInterval : Now;
+
+	MarkEffectsDirty();
+
+	if (auto Processor = ASEffectProcessor::Get(GetWorld())) {
+		Processor->RegisterStack(this);
+	}
+}
+
+void USEffectStackComponent::ClearEffects() {
+	if (ActiveEffects.Num() == 0 || GetOwnerRole() != ROLE_Authority) { return; }
+
+	ActiveEffects.Reset();
+	MarkEffectsDirty();
+}
+
+bool USEffectStackComponent::ProcessEffects(float Now) {
+	bool bChanged = false;
+
+	for (int32 Index = ActiveEffects.Num() - 1; Index >= 0; --Index) {
+		FSActiveEffect& Active = ActiveEffects[Index];
+		const USEffectData* Effect = Active.Effect;
+
+		if (Effect && Effect->Kind == ESEffectKind::HealOverTime && HealthComp) {
+			// Catches up on heals a long frame skipped, the last one lands on the end time
+			const float LastTickTime = FMath::Min(Now, Active.EndTime);
+			while (Active.NextTickTime <= LastTickTime) {
+				HealthComp->Heal(Effect->Magnitude);
+
+				if (Effect->TickInterval <= 0.f) {
+					Active.NextTickTime = MAX_flt;
+				} else {
+					Active.NextTickTime += Effect->TickInterval;
+				}
+			}
+		}
+
+		if (!Effect || Active.EndTime <= Now) {
+			ActiveEffects.RemoveAt(Index, 1, false);
+			bChanged = true;
+		}
+	}
+
+	if (bChanged) {
+		MarkEffectsDirty();
+	}
+
+	return ActiveEffects.Num() > 0;
+}
+
+void USEffectStackComponent::MarkEffectsDirty() {
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(USEffectStackComponent, ActiveEffects));
+
+	if (auto MyOwner = GetOwner()) {
+		MyOwner->ForceNetUpdate();
+	}
+
+	UpdateModifiers();
+}
+
+void USEffectStackComponent::OnRep_ActiveEffects() {
+	FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(USEffectStackComponent, ActiveEffects));
+
+	UpdateModifiers();
+}
+
+void USEffectStackComponent::UpdateModifiers() {
+	DamageMultiplier = 1.f;
+	float SpeedMultiplier = 1.f;
+
+	for (const FSActiveEffect& Active : ActiveEffects) {
+		if (!Active.Effect) { continue; }
+
+		switch (Active.Effect->Kind) {
+		case ESEffectKind::DamageMultiplier:
+			DamageMultiplier *= Active.Effect->Magnitude;
+			break;
+		case ESEffectKind::SpeedMultiplier:
+			SpeedMultiplier *= Active.Effect->Magnitude;
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Applied on clients as well, so movement prediction agrees with the server
+	if (MovementComp) {
+		MovementComp->MaxWalkSpeed = BaseMaxWalkSpeed * SpeedMultiplier;
+	}
+
+	if (OnEffectsChanged.IsBound()) {
+		OnEffectsChanged.Broadcast(this);
+	}
+}
+
+void USEffectStackComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(USEffectStackComponent, ActiveEffects);
+}
@@ -0,0 +1,142 @@
+#include "SEventBus.h"
+#include "SHealthComponent.h"
+#include "SWorldManager.h"
+#include "STraceBatcher.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flush Gameplay Events"), STAT_FlushGameplayEvents, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Events"), STAT_GameplayEvents, STATGROUP_CoopGame);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchEventBusCommand(
+	TEXT("COOP.BenchEventBus"),
+	TEXT("Time dynamic, native and batched delivery of health change events. Optional argument: number of events (default 10000)"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		const int32 NrOfEvents = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+		ASEventBus::RunBenchmark(FMath::Max(NrOfEvents, 1), Ar);
+	}));
+
+ASEventBus::ASEventBus() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Run after timers and the trace batcher so the frame's hits are included, see BeginPlay
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	SetReplicates(false);
+
+	BenchmarkEventsReceived = 0;
+	bFlushing = false;
+}
+
+ASEventBus* ASEventBus::Get(UWorld* World) {
+	return GetWorldManager<ASEventBus>(World);
+}
+
+void ASEventBus::BeginPlay() {
+	Super::BeginPlay();
+
+	// Same tick group, so only a prerequisite keeps batched hits from going out a frame late
+	if (auto TraceBatcher = ASTraceBatcher::Get(GetWorld())) {
+		AddTickPrerequisiteActor(TraceBatcher);
+	}
+}
+
+void ASEventBus::PublishDamage(const FSDamageEvent& Event) {
+	COOP_LLM_SCOPE(ESMemoryTag::Events);
+
+	if (OnDamageEvents.IsBound()) {
+		PendingDamageEvents.Add(Event);
+	}
+}
+
+void ASEventBus::PublishKill(const FSKillEvent& Event) {
+	COOP_LLM_SCOPE(ESMemoryTag::Events);
+
+	if (OnKillEvents.IsBound()) {
+		PendingKillEvents.Add(Event);
+	}
+}
+
+void ASEventBus::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	FlushEvents();
+}
+
+void ASEventBus::FlushEvents() {
+	if (bFlushing || (PendingDamageEvents.Num() == 0 && PendingKillEvents.Num() == 0)) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_FlushGameplayEvents);
+	INC_DWORD_STAT_BY(STAT_GameplayEvents, PendingDamageEvents.Num() + PendingKillEvents.Num());
+
+	// Listeners may publish new events, those go out next frame. Swapping keeps both buffers allocated
+	Swap(PendingDamageEvents, DispatchingDamageEvents);
+	Swap(PendingKillEvents, DispatchingKillEvents);
+
+	TGuardValue<bool> FlushGuard(bFlushing, true);
+
+	if (DispatchingDamageEvents.Num() > 0) {
+		OnDamageEvents.Broadcast(DispatchingDamageEvents);
+		DispatchingDamageEvents.Reset();
+	}
+
+	if (DispatchingKillEvents.Num() > 0) {
+		OnKillEvents.Broadcast(DispatchingKillEvents);
+		DispatchingKillEvents.Reset();
+	}
+}
+
+void ASEventBus::HandleBenchmarkHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
+	const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+	BenchmarkEventsReceived++;
+}
+
+void ASEventBus::RunBenchmark(int32 NrOfEvents, FOutputDevice& Ar) {
+	// A private bus that's never spawned, so it stays out of the world's one bus and its listeners. Flushed by hand below
+	auto Bus = NewObject<ASEventBus>(GetTransientPackage(), NAME_None, RF_Transient);
+	auto HealthComp = NewObject<USHealthComponent>(Bus, NAME_None, RF_Transient);
+
+	auto Report = [&Ar, NrOfEvents](const TCHAR* Name, double StartTime, int32 Received) {
+		const double Ms = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		Ar.Logf(TEXT("  %-8s %8.3f ms  %7.1f ns/event  (%d received)"), Name, Ms, Ms * 1000000.0 / NrOfEvents, Received);
+	};
+
+	Ar.Logf(TEXT("Delivering %d health change events to one listener"), NrOfEvents);
+
+	HealthComp->OnHealthChanged.AddDynamic(Bus, &ASEventBus::HandleBenchmarkHealthChanged);
+	Bus->BenchmarkEventsReceived = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NrOfEvents; ++Index) {
+		HealthComp->OnHealthChanged.Broadcast(HealthComp, 50.f, 1.f, nullptr, nullptr, nullptr);
+	}
+	Report(TEXT("Dynamic"), StartTime, Bus->BenchmarkEventsReceived);
+	HealthComp->OnHealthChanged.RemoveAll(Bus);
+
+	HealthComp->OnHealthChangedNative.AddUObject(Bus, &ASEventBus::HandleBenchmarkHealthChanged);
+	Bus->BenchmarkEventsReceived = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NrOfEvents; ++Index) {
+		HealthComp->OnHealthChangedNative.Broadcast(HealthComp, 50.f, 1.f, nullptr, nullptr, nullptr);
+	}
+	Report(TEXT("Native"), StartTime, Bus->BenchmarkEventsReceived);
+	HealthComp->OnHealthChangedNative.RemoveAll(Bus);
+
+	int32 BatchedReceived = 0;
+	Bus->OnDamageEvents.AddLambda([&BatchedReceived](const TArray<FSDamageEvent>& Events) {
+		BatchedReceived += Events.Num();
+	});
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NrOfEvents; ++Index) {
+		FSDamageEvent Event;
+		Event.HealthComp = HealthComp;
+		Event.Health = 50.f;
+		Event.HealthDelta = 1.f;
+		Bus->PublishDamage(Event);
+	}
+	Bus->FlushEvents();
+	Report(TEXT("Batched"), StartTime, BatchedReceived);
+
+	Bus->OnDamageEvents.Clear();
+	Bus->MarkPendingKill();
+}
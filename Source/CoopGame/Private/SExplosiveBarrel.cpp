@@ -2,22 +2,29 @@
 
 #include "SExplosiveBarrel.h"
 #include "SHealthComponent.h"
+#include "SNavObstacleComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/RadialForceComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "UnrealNetwork.h"
+#include "SNetStats.h"
+#include "SAssetPreloader.h"
+#include "TimerManager.h"
+#include "SMemoryTags.h"
 
 
 // Sets default values
 ASExplosiveBarrel::ASExplosiveBarrel()
 {
 	HealthComp = CreateDefaultSubobject<USHealthComponent>(TEXT("HealthComp"));
-	HealthComp->OnHealthChanged.AddDynamic(this, &ASExplosiveBarrel::OnHealthChanged);
+	HealthComp->OnHealthChangedNative.AddUObject(this, &ASExplosiveBarrel::OnHealthChanged);
 
 	MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
 	MeshComp->SetSimulatePhysics(true);
 	MeshComp->SetCollisionObjectType(ECC_PhysicsBody);
+	MeshComp->SetCanEverAffectNavigation(false);
+	MeshComp->BodyInstance.bGenerateWakeEvents = true;
 	RootComponent = MeshComp;
 
 	RadialForceComp = CreateDefaultSubobject<URadialForceComponent>(TEXT("RadialForceComp"));
@@ -27,10 +34,96 @@ ASExplosiveBarrel::ASExplosiveBarrel()
 	RadialForceComp->bAutoActivate = false;
 	RadialForceComp->bIgnoreOwningActor = true;
 
+	NavObstacleComp = CreateDefaultSubobject<USNavObstacleComponent>(TEXT("NavObstacleComp"));
+
 	ExplosionImpulse = 400.f;
+	SettleTime = 5.f;
+	SettleSpeed = 10.f;
 
 	SetReplicates(true);
 	SetReplicateMovement(true);
+	NetDormancy = DORM_Initial;
+}
+
+void ASExplosiveBarrel::BeginPlay() {
+	Super::BeginPlay();
+
+	// Assets saved while this was a dynamic binding still carry it
+	HealthComp->OnHealthChanged.Remove(this, GET_FUNCTION_NAME_CHECKED(ASExplosiveBarrel, OnHealthChanged));
+
+	InitialTransform = GetActorTransform();
+	IntactMaterial = MeshComp->GetMaterial(0);
+
+	if (HasAuthority()) {
+		MeshComp->OnComponentWake.AddDynamic(this, &ASExplosiveBarrel::OnMeshWake);
+		MeshComp->OnComponentSleep.AddDynamic(this, &ASExplosiveBarrel::OnMeshSleep);
+	}
+
+	if (auto Preloader = ASAssetPreloader::Get(GetWorld())) {
+		Preloader->PreloadClass(GetClass());
+	}
+}
+
+void ASExplosiveBarrel::Reset() {
+	Super::Reset();
+
+	if (!HasAuthority()) { return; }
+
+	// Settle left an exploded barrel static, clients follow through the replicated movement
+	MeshComp->SetSimulatePhysics(true);
+	MeshComp->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	MeshComp->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+	SetActorTransform(InitialTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	HealthComp->ResetHealth();
+
+	if (bExploded) {
+		bExploded = false;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASExplosiveBarrel, bExploded));
+		OnRep_Exploded();
+	}
+
+	Settle();
+}
+
+void ASExplosiveBarrel::Settle() {
+	if (MeshComp->IsSimulatingPhysics() && MeshComp->RigidBodyIsAwake()) {
+		// Still rolling, look again in a moment
+		if (bExploded && MeshComp->GetPhysicsLinearVelocity().SizeSquared() > FMath::Square(SettleSpeed)) {
+			GetWorldTimerManager().SetTimer(TimerHandle_Settle, this, &ASExplosiveBarrel::Settle, 1.f, false);
+			return;
+		}
+
+		// An intact barrel keeps simulating, OnMeshSleep settles it once it's at rest
+		if (!bExploded) { return; }
+	}
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_Settle);
+
+	// Where an exploded barrel lands it stays, as a static prop rather than a physics body
+	if (bExploded) {
+		MeshComp->SetSimulatePhysics(false);
+	}
+
+	// Goes dormant once the current state has been sent
+	SetNetDormancy(DORM_DormantAll);
+	ForceNetUpdate();
+}
+
+void ASExplosiveBarrel::OnMeshWake(UPrimitiveComponent* WakeComponent, FName BoneName) {
+	SetNetDormancy(DORM_Awake);
+}
+
+void ASExplosiveBarrel::OnMeshSleep(UPrimitiveComponent* SleepComponent, FName BoneName) {
+	// An exploded barrel settles on its own timer
+	if (!GetWorldTimerManager().IsTimerActive(TimerHandle_Settle)) {
+		Settle();
+	}
+}
+
+void ASExplosiveBarrel::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	OutAssets.Add(ExplosionEffect.ToSoftObjectPath());
+	OutAssets.Add(ExplodedMaterial.ToSoftObjectPath());
 }
 
 void ASExplosiveBarrel::OnHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
@@ -39,8 +132,12 @@ void ASExplosiveBarrel::OnHealthChanged(USHealthComponent* OwningHealthComponent
 
 	if (Health <= 0.f) {
 		bExploded = true;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASExplosiveBarrel, bExploded));
 		OnRep_Exploded();
 
+		SetNetDormancy(DORM_Awake);
+		GetWorldTimerManager().SetTimer(TimerHandle_Settle, this, &ASExplosiveBarrel::Settle, SettleTime, false);
+
 		const FVector BoostIntensity = FVector::UpVector * ExplosionImpulse;
 		MeshComp->AddImpulse(BoostIntensity, NAME_None, true);
 
@@ -49,8 +146,24 @@ void ASExplosiveBarrel::OnHealthChanged(USHealthComponent* OwningHealthComponent
 }
 
 void ASExplosiveBarrel::OnRep_Exploded() {
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, GetActorLocation());
-	MeshComp->SetMaterial(0, ExplodedMaterial);
+	if (!HasAuthority()) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASExplosiveBarrel, bExploded));
+	}
+
+	if (GetNetMode() == NM_DedicatedServer) { return; }
+
+	// Cleared by a match reset
+	if (!bExploded) {
+		MeshComp->SetMaterial(0, IntactMaterial);
+		return;
+	}
+
+	COOP_LLM_SCOPE(ESMemoryTag::Effects);
+	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect.Get(), GetActorLocation());
+
+	if (auto Material = ExplodedMaterial.Get()) {
+		MeshComp->SetMaterial(0, Material);
+	}
 }
 
 void ASExplosiveBarrel::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
@@ -4,9 +4,36 @@
 #include "SHealthComponent.h"
 #include "SGameState.h"
 #include "SPlayerState.h"
+#include "CoopGame.h"
+#include "HAL/PlatformMemory.h"
+#include "AI/STrackerBot.h"
+#include "SEventBus.h"
+#include "SMemoryTags.h"
+#include "SSpikeCatcher.h"
+#include "SMemoryBudgets.h"
+#include "SMatchLog.h"
+#include "NavigationSystem.h"
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SpawnBotsCommand(
+	TEXT("COOP.SpawnBots"),
+	TEXT("Server only: spawn bots around the first player to load test replication and AI. Arguments: count (default 100), radius (default 2000)"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		auto GM = World ? World->GetAuthGameMode<ASGameMode>() : nullptr;
+		if (!GM) {
+			Ar.Log(TEXT("COOP.SpawnBots needs to run on the server"));
+			return;
+		}
+
+		const int32 NrOfBots = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+		const float Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 2000.f;
+		GM->SpawnTestBots(NrOfBots, Radius, Ar);
+	}));
 
 ASGameMode::ASGameMode() {
 	TimeBetweenWaves = 2.f;
+	TimeBeforeMatchReset = 5.f;
+	BotSpawnRadius = 2000.f;
+	MaxPooledBots = 32;
 
 	GameStateClass = ASGameState::StaticClass();
 	PlayerStateClass = ASPlayerState::StaticClass();
@@ -18,11 +45,31 @@ ASGameMode::ASGameMode() {
 void ASGameMode::StartPlay() {
 	Super::StartPlay();
 
+	if (GetNetMode() == NM_DedicatedServer) {
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		UE_LOG(LogCoopGame, Log, TEXT("Dedicated server ready: boot %.2fs, resident %.1f MB (peak %.1f MB)"),
+			FPlatformTime::Seconds() - GStartTime, MemoryStats.UsedPhysical / (1024.f * 1024.f), MemoryStats.PeakUsedPhysical / (1024.f * 1024.f));
+	}
+
+	// Watches frame times for the rest of the match, see COOP.SpikeCatcher
+	ASSpikeCatcher::Get(GetWorld());
+	ASMemoryBudgets::Get(GetWorld());
+
 	PrepareForNextWave();
 }
 
+void ASGameMode::SetPlayerDefaults(APawn* PlayerPawn) {
+	Super::SetPlayerDefaults(PlayerPawn);
+
+	if (PlayerPawn) {
+		FSMatchLog::Get().LogSpawn(PlayerPawn, false);
+	}
+}
+
 void ASGameMode::Tick(float DeltaSeconds) {
 	Super::Tick(DeltaSeconds);
+
+	if (GetWorldTimerManager().IsTimerActive(TimerHandle_MatchReset)) { return; }
 	
 	CheckWaveState();
 	CheckAnyPlayerAlive();
@@ -47,6 +94,9 @@ void ASGameMode::CheckWaveState() {
 
 		if (!TestPawn || TestPawn->IsPlayerControlled()) { continue; }
 
+		auto Bot = Cast<ASTrackerBot>(TestPawn);
+		if (Bot && Bot->IsPooled()) { continue; }
+
 		auto HealthComp = Cast<USHealthComponent>(TestPawn->GetComponentByClass(USHealthComponent::StaticClass()));
 		if (HealthComp && HealthComp->GetHealth() > 0.f) {
 			bIsAnyBotAlive = true;
@@ -61,6 +111,9 @@ void ASGameMode::CheckWaveState() {
 }
 
 void ASGameMode::CheckAnyPlayerAlive() {
+	// An empty server hasn't lost
+	if (GetNumPlayers() == 0) { return; }
+
 	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
 		auto PC = It->Get();
 
@@ -76,15 +129,101 @@ void ASGameMode::CheckAnyPlayerAlive() {
 }
 
 void ASGameMode::GameOver() {
-	// TODO
+	GetWorldTimerManager().ClearTimer(TimerHandle_BotSpawner);
+	GetWorldTimerManager().ClearTimer(TimerHandle_NextWaveStart);
+	NrOfBotsToSpawn = 0;
+
 	SetWaveState(EWaveState::GameOver);
 
 	UE_LOG(LogTemp, Warning, TEXT("Game Over!  Players Died"))
+
+	GetWorldTimerManager().SetTimer(TimerHandle_MatchReset, this, &ASGameMode::ResetMatch, FMath::Max(TimeBeforeMatchReset, 0.01f), false);
+}
+
+void ASGameMode::BroadcastActorKilled(AActor* VictimActor, AActor* KillerActor, AController* KillerController) {
+	FSMatchLog::Get().LogKill(VictimActor, KillerActor);
+
+	OnActorKilledNative.Broadcast(VictimActor, KillerActor, KillerController);
+
+	if (OnActorKilled.IsBound()) {
+		OnActorKilled.Broadcast(VictimActor, KillerActor, KillerController);
+	}
+
+	if (auto EventBus = ASEventBus::Get(GetWorld())) {
+		FSKillEvent Event;
+		Event.Victim = VictimActor;
+		Event.Killer = KillerActor;
+		Event.KillerController = KillerController;
+		EventBus->PublishKill(Event);
+	}
+}
+
+void ASGameMode::ResetMatch() {
+	const double StartTime = FPlatformTime::Seconds();
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_MatchReset);
+	GetWorldTimerManager().ClearTimer(TimerHandle_BotSpawner);
+	GetWorldTimerManager().ClearTimer(TimerHandle_NextWaveStart);
+
+	NrOfBotsToSpawn = 0;
+	WaveCount = 0;
+
+	// Resets every controller, player state and actor in the level: player pawns are destroyed,
+	// bots go back into the pool and level actors restore their starting state
+	ResetLevel();
+
+	PrepareForNextWave();
+
+	UE_LOG(LogCoopGame, Log, TEXT("Match reset in %.2fms, %d bot(s) pooled"), (FPlatformTime::Seconds() - StartTime) * 1000.0, BotPool.Num());
+}
+
+APawn* ASGameMode::AcquireBot(TSubclassOf<APawn> BotClass, const FTransform& SpawnTransform) {
+	if (!BotClass) { return nullptr; }
+
+	for (int32 Index = BotPool.Num() - 1; Index >= 0; --Index) {
+		auto Bot = BotPool[Index];
+
+		if (!Bot || Bot->IsPendingKill()) {
+			BotPool.RemoveAtSwap(Index);
+		} else if (Bot->GetClass() == BotClass) {
+			BotPool.RemoveAtSwap(Index);
+			Bot->Reactivate(SpawnTransform);
+			FSMatchLog::Get().LogSpawn(Bot, true);
+			return Bot;
+		}
+	}
+
+	COOP_LLM_SCOPE(ESMemoryTag::Bots);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	auto Bot = GetWorld()->SpawnActor<APawn>(BotClass, SpawnTransform, SpawnParams);
+	if (Bot) {
+		FSMatchLog::Get().LogSpawn(Bot, false);
+	}
+
+	return Bot;
+}
+
+void ASGameMode::ReleaseBot(ASTrackerBot* Bot) {
+	if (!Bot || BotPool.Contains(Bot)) { return; }
+
+	if (BotPool.Num() >= MaxPooledBots) {
+		Bot->Destroy();
+		return;
+	}
+
+	BotPool.Add(Bot);
 }
 
 void ASGameMode::SetWaveState(EWaveState NewState) {
 	auto GS = GetGameState<ASGameState>();
 	if (ensureAlways(GS)) {
+		if (GS->GetWaveState() != NewState) {
+			FSMatchLog::Get().LogWaveState(GetWorld(), (uint8)NewState, WaveCount);
+		}
+
 		GS->SetWaveState(NewState);
 	}
 }
@@ -100,6 +239,12 @@ void ASGameMode::RestartDeadPlayers() {
 
 void ASGameMode::PrepareForNextWave() {
 	GetWorldTimerManager().SetTimer(TimerHandle_NextWaveStart, this, &ASGameMode::StartWave, TimeBetweenWaves, false);
+
+	auto GS = GetGameState<ASGameState>();
+	if (GS) {
+		GS->SetUpcomingBotClasses(GetBotClassesForWave(WaveCount + 1));
+	}
+
 	SetWaveState(EWaveState::WaitingToStart);
 	RestartDeadPlayers();
 }
@@ -109,8 +254,75 @@ void ASGameMode::EndWave() {
 	SetWaveState(EWaveState::WaitingToComplete);
 }
 
+TArray<TSubclassOf<APawn>> ASGameMode::GetBotClassesForWave_Implementation(int32 WaveNumber) {
+	return WaveBotClasses;
+}
+
+void ASGameMode::SpawnTestBots(int32 NrOfBots, float Radius, FOutputDevice& Ar) {
+	TArray<TSubclassOf<APawn>> BotClasses = GetBotClassesForWave(1);
+	if (BotClasses.Num() == 0 || !BotClasses[0]) {
+		Ar.Log(TEXT("No bot classes set in WaveBotClasses"));
+		return;
+	}
+
+	FVector Center = FVector::ZeroVector;
+	auto PC = GetWorld()->GetFirstPlayerController();
+	if (PC && PC->GetPawn()) {
+		Center = PC->GetPawn()->GetActorLocation();
+	}
+
+	int32 NrSpawned = 0;
+	for (int32 Index = 0; Index < NrOfBots; ++Index) {
+		const float Angle = 2.f * PI * Index / FMath::Max(NrOfBots, 1);
+		const FVector Location = Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Radius + FVector(0.f, 0.f, 100.f);
+
+		if (AcquireBot(BotClasses[0], FTransform(Location))) {
+			NrSpawned++;
+		}
+	}
+
+	Ar.Logf(TEXT("Spawned %d of %d %s bot(s)"), NrSpawned, NrOfBots, *BotClasses[0]->GetName());
+}
+
+void ASGameMode::SpawnWaveBot() {
+	TArray<TSubclassOf<APawn>> BotClasses = GetBotClassesForWave(WaveCount);
+	BotClasses.RemoveAll([](const TSubclassOf<APawn>& BotClass) { return !BotClass; });
+
+	FTransform SpawnTransform;
+	if (BotClasses.Num() == 0 || !GetBotSpawnTransform(SpawnTransform)) {
+		SpawnNewBot();
+		return;
+	}
+
+	AcquireBot(BotClasses[FMath::RandRange(0, BotClasses.Num() - 1)], SpawnTransform);
+}
+
+bool ASGameMode::GetBotSpawnTransform_Implementation(FTransform& OutTransform) {
+	TArray<APawn*> Players;
+	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		auto PC = It->Get();
+		auto MyPawn = PC ? PC->GetPawn() : nullptr;
+		auto HealthComp = MyPawn ? MyPawn->FindComponentByClass<USHealthComponent>() : nullptr;
+
+		if (HealthComp && HealthComp->GetHealth() > 0.f) {
+			Players.Add(MyPawn);
+		}
+	}
+
+	auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (Players.Num() == 0 || !NavSys) { return false; }
+
+	const FVector Origin = Players[FMath::RandRange(0, Players.Num() - 1)]->GetActorLocation();
+
+	FNavLocation SpawnLocation;
+	if (!NavSys->GetRandomReachablePointInRadius(Origin, BotSpawnRadius, SpawnLocation)) { return false; }
+
+	OutTransform = FTransform(SpawnLocation.Location + FVector(0.f, 0.f, 100.f));
+	return true;
+}
+
 void ASGameMode::SpawnBotTimerElapsed() {
-	SpawnNewBot();
+	SpawnWaveBot();
 
 	NrOfBotsToSpawn--;
 
@@ -2,22 +2,62 @@
 
 #include "SGameState.h"
 #include "UnrealNetwork.h"
+#include "SNetStats.h"
+#include "SAssetPreloader.h"
+#include "GameFramework/Pawn.h"
 
 
 void ASGameState::SetWaveState(EWaveState NewState) {
 	if (HasAuthority()) {
 		EWaveState OldState = WaveState;
 		WaveState = NewState;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASGameState, WaveState));
+		ForceNetUpdate();
 		OnRep_WaveState(OldState);
 	}
 }
 
 void ASGameState::OnRep_WaveState(EWaveState OldState) {
+	if (!HasAuthority()) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASGameState, WaveState));
+	}
+
+	if (WaveState == EWaveState::WaitingToStart) {
+		PreloadUpcomingWave();
+	}
+
 	WaveStateChanged(WaveState, OldState);
 }
 
+void ASGameState::SetUpcomingBotClasses(const TArray<TSubclassOf<APawn>>& BotClasses) {
+	if (HasAuthority()) {
+		UpcomingBotClasses = BotClasses;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASGameState, UpcomingBotClasses));
+		ForceNetUpdate();
+		OnRep_UpcomingBotClasses();
+	}
+}
+
+void ASGameState::OnRep_UpcomingBotClasses() {
+	if (!HasAuthority()) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASGameState, UpcomingBotClasses));
+	}
+
+	// The classes may replicate after the wave state did
+	if (WaveState == EWaveState::WaitingToStart) {
+		PreloadUpcomingWave();
+	}
+}
+
+void ASGameState::PreloadUpcomingWave() {
+	if (auto Preloader = ASAssetPreloader::Get(GetWorld())) {
+		Preloader->PrepareForWave(UpcomingBotClasses);
+	}
+}
+
 void ASGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(ASGameState, WaveState);
+	DOREPLIFETIME(ASGameState, UpcomingBotClasses);
 }
@@ -4,6 +4,10 @@
 #include "UnrealNetwork.h"
 #include "Engine/World.h"
 #include "SGameMode.h"
+#include "SNetStats.h"
+#include "SEventBus.h"
+#include "SSpikeCatcher.h"
+#include "SMatchLog.h"
 
 
 // Sets default values for this component's properties
@@ -42,13 +46,53 @@ void USHealthComponent::BeginPlay()
 	}
 
 	Health = DefaultHealth;
+
+	EventBus = ASEventBus::Get(GetWorld());
 }
 
 float USHealthComponent::GetHealth() const { return Health; }
 
+void USHealthComponent::ResetHealth() {
+	if (GetOwnerRole() != ROLE_Authority) { return; }
+
+	bIsDead = false;
+	Health = DefaultHealth;
+	MarkHealthDirty();
+}
+
+void USHealthComponent::MarkHealthDirty() {
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(USHealthComponent, Health));
+
+	// Sends the change now even if the owner is dormant or between net updates
+	if (auto MyOwner = GetOwner()) {
+		MyOwner->ForceNetUpdate();
+	}
+}
+
 void USHealthComponent::OnRep_Health(float OldHealth) {
+	FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(USHealthComponent, Health));
+
 	float Damage = Health - OldHealth;
-	OnHealthChanged.Broadcast(this, Health, Damage, nullptr, nullptr, nullptr);
+	BroadcastHealthChanged(Damage, nullptr, nullptr, nullptr);
+}
+
+void USHealthComponent::BroadcastHealthChanged(float HealthDelta, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+	OnHealthChangedNative.Broadcast(this, Health, HealthDelta, DamageType, InstigatedBy, DamageCauser);
+
+	if (OnHealthChanged.IsBound()) {
+		OnHealthChanged.Broadcast(this, Health, HealthDelta, DamageType, InstigatedBy, DamageCauser);
+	}
+
+	if (EventBus) {
+		FSDamageEvent Event;
+		Event.HealthComp = this;
+		Event.Health = Health;
+		Event.HealthDelta = HealthDelta;
+		Event.DamageType = DamageType;
+		Event.InstigatedBy = InstigatedBy;
+		Event.DamageCauser = DamageCauser;
+		EventBus->PublishDamage(Event);
+	}
 }
 
 void USHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
@@ -58,13 +102,16 @@ void USHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage,
 
 	Health = FMath::Clamp(Health - Damage, 0.f, DefaultHealth);
 	bIsDead = Health <= 0.f;
+	FSFrameCounters::Get(this).DamageEvents++;
+	FSMatchLog::Get().LogDamage(DamagedActor, DamageCauser, Damage);
+	MarkHealthDirty();
 
-	OnHealthChanged.Broadcast(this, Health, Damage, DamageType, InstigatedBy, DamageCauser);
+	BroadcastHealthChanged(Damage, DamageType, InstigatedBy, DamageCauser);
 
 	if (bIsDead) {
 		auto GM = Cast<ASGameMode>(GetWorld()->GetAuthGameMode());
 		if (GM) {
-			GM->OnActorKilled.Broadcast(GetOwner(), DamageCauser, InstigatedBy);
+			GM->BroadcastActorKilled(GetOwner(), DamageCauser, InstigatedBy);
 		}
 	}
 }
@@ -79,8 +126,9 @@ void USHealthComponent::Heal(float HealAmount) {
 	if (HealAmount <= 0.f || Health <= 0.f) { return; }
 
 	Health = FMath::Clamp(Health + HealAmount, 0.f, DefaultHealth);
+	MarkHealthDirty();
 
-	OnHealthChanged.Broadcast(this, Health, -HealAmount, nullptr, nullptr, nullptr);
+	BroadcastHealthChanged(-HealAmount, nullptr, nullptr, nullptr);
 
-	UE_LOG(LogTemp, Warning, TEXT("Health Changed: %s (+%s)"), *FString::SanitizeFloat(Health), *FString::SanitizeFloat(HealAmount))
+	FSMatchLog::Get().LogHeal(GetOwner(), HealAmount);
 }
@@ -0,0 +1,261 @@
+#include "SHitboxRegistry.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Refresh Hitboxes"), STAT_RefreshHitboxes, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitboxes"), STAT_Hitboxes, STATGROUP_CoopGame);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchHitboxTracesCommand(
+	TEXT("COOP.BenchHitboxTraces"),
+	TEXT("Cast random rays at the pawns' hitboxes and log rays per second for hitbox raycasts and for LineTraceSingleByChannel. Optional argument: number of rays (default 100000)"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		const int32 NrOfRays = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+		ASHitboxRegistry::RunBenchmark(World, FMath::Max(NrOfRays, 1), Ar);
+	}));
+
+ASHitboxRegistry::ASHitboxRegistry() {
+	// Refreshed on demand by whoever traces first in a frame
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetReplicates(false);
+
+	LastRefreshFrame = 0;
+}
+
+ASHitboxRegistry* ASHitboxRegistry::Get(UWorld* World) {
+	return GetWorldManager<ASHitboxRegistry>(World);
+}
+
+void ASHitboxRegistry::AddHitbox(UPrimitiveComponent* Component, FName SocketA, FName SocketB, float Radius, EPhysicalSurface SurfaceType) {
+	if (!Component || Radius <= 0.f) { return; }
+
+	FSource& Source = Sources[Sources.AddDefaulted()];
+	Source.Component = Component;
+	Source.SocketA = SocketA;
+	Source.SocketB = SocketB;
+	Source.Radius = Radius;
+	Source.SurfaceType = SurfaceType;
+
+	LastRefreshFrame = 0;
+}
+
+void ASHitboxRegistry::RemoveHitboxes(AActor* Owner) {
+	Sources.RemoveAll([Owner](const FSource& Source) {
+		return !Source.Component.IsValid() || Source.Component->GetOwner() == Owner;
+	});
+
+	LastRefreshFrame = 0;
+}
+
+void ASHitboxRegistry::Refresh() {
+	if (LastRefreshFrame == GFrameCounter) { return; }
+	LastRefreshFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_RefreshHitboxes);
+
+	const int32 NrOfSources = Sources.Num();
+	const int32 NrOfLanes = Align(NrOfSources, 4);
+
+	AX.SetNumUninitialized(NrOfLanes, false);
+	AY.SetNumUninitialized(NrOfLanes, false);
+	AZ.SetNumUninitialized(NrOfLanes, false);
+	EX.SetNumUninitialized(NrOfLanes, false);
+	EY.SetNumUninitialized(NrOfLanes, false);
+	EZ.SetNumUninitialized(NrOfLanes, false);
+	ELengthSquared.SetNumUninitialized(NrOfLanes, false);
+	RadiusSquared.SetNumUninitialized(NrOfLanes, false);
+	LaneOwners.SetNumUninitialized(NrOfLanes, false);
+	LaneComponents.SetNumUninitialized(NrOfLanes, false);
+
+	int32 NrOfActive = 0;
+
+	for (int32 Lane = 0; Lane < NrOfLanes; ++Lane) {
+		UPrimitiveComponent* Component = Lane < NrOfSources ? Sources[Lane].Component.Get() : nullptr;
+
+		// Same rules as a world trace: the hitbox's component has to block weapon traces
+		const bool bActive = Component && Component->IsCollisionEnabled() && Component->GetCollisionResponseToChannel(COLLISION_WEAPON) == ECR_Block;
+
+		if (!bActive) {
+			AX[Lane] = AY[Lane] = AZ[Lane] = 0.f;
+			EX[Lane] = EY[Lane] = EZ[Lane] = 0.f;
+			ELengthSquared[Lane] = 0.f;
+			RadiusSquared[Lane] = -1.f;
+			LaneOwners[Lane] = nullptr;
+			LaneComponents[Lane] = nullptr;
+			continue;
+		}
+
+		const FSource& Source = Sources[Lane];
+		const FVector A = Component->GetSocketLocation(Source.SocketA);
+		const FVector E = (Source.SocketB == Source.SocketA ? A : Component->GetSocketLocation(Source.SocketB)) - A;
+		const float Radius = Source.Radius * Component->GetComponentScale().GetAbsMax();
+
+		AX[Lane] = A.X;
+		AY[Lane] = A.Y;
+		AZ[Lane] = A.Z;
+		EX[Lane] = E.X;
+		EY[Lane] = E.Y;
+		EZ[Lane] = E.Z;
+		ELengthSquared[Lane] = E.SizeSquared();
+		RadiusSquared[Lane] = FMath::Square(Radius);
+		LaneOwners[Lane] = Component->GetOwner();
+		LaneComponents[Lane] = Component;
+
+		NrOfActive++;
+	}
+
+	SET_DWORD_STAT(STAT_Hitboxes, NrOfActive);
+}
+
+bool ASHitboxRegistry::Raycast(const FVector& Start, const FVector& End, const AActor* IgnoredActor, FSHitboxHit& OutHit) const {
+	const FVector D = End - Start;
+	const float DLengthSquared = D.SizeSquared();
+	if (DLengthSquared <= SMALL_NUMBER) { return false; }
+
+	const float DLength = FMath::Sqrt(DLengthSquared);
+	float NearestTime = 2.f;
+	int32 NearestLane = INDEX_NONE;
+
+	const VectorRegister SX = VectorSetFloat1(Start.X);
+	const VectorRegister SY = VectorSetFloat1(Start.Y);
+	const VectorRegister SZ = VectorSetFloat1(Start.Z);
+	const VectorRegister DX = VectorSetFloat1(D.X);
+	const VectorRegister DY = VectorSetFloat1(D.Y);
+	const VectorRegister DZ = VectorSetFloat1(D.Z);
+	const VectorRegister InvDLengthSquared = VectorSetFloat1(1.f / DLengthSquared);
+	const VectorRegister Tiny = VectorSetFloat1(SMALL_NUMBER);
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister One = VectorOne();
+
+	MS_ALIGN(16) float RayTimes[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float DistancesSquared[4] GCC_ALIGN(16);
+
+	for (int32 Lane = 0; Lane < AX.Num(); Lane += 4) {
+		// Closest points between the ray S + D s and each hitbox's axis A + E t, s and t in [0, 1]
+		const VectorRegister RX = VectorSubtract(SX, VectorLoadAligned(&AX[Lane]));
+		const VectorRegister RY = VectorSubtract(SY, VectorLoadAligned(&AY[Lane]));
+		const VectorRegister RZ = VectorSubtract(SZ, VectorLoadAligned(&AZ[Lane]));
+		const VectorRegister LaneEX = VectorLoadAligned(&EX[Lane]);
+		const VectorRegister LaneEY = VectorLoadAligned(&EY[Lane]);
+		const VectorRegister LaneEZ = VectorLoadAligned(&EZ[Lane]);
+		const VectorRegister e = VectorLoadAligned(&ELengthSquared[Lane]);
+
+		const VectorRegister b = VectorMultiplyAdd(DX, LaneEX, VectorMultiplyAdd(DY, LaneEY, VectorMultiply(DZ, LaneEZ)));
+		const VectorRegister c = VectorMultiplyAdd(DX, RX, VectorMultiplyAdd(DY, RY, VectorMultiply(DZ, RZ)));
+		const VectorRegister f = VectorMultiplyAdd(LaneEX, RX, VectorMultiplyAdd(LaneEY, RY, VectorMultiply(LaneEZ, RZ)));
+
+		// a * e - b * b, with a = |D|^2 the same for every lane
+		const VectorRegister Denominator = VectorMax(VectorSubtract(VectorMultiply(VectorSetFloat1(DLengthSquared), e), VectorMultiply(b, b)), Tiny);
+
+		// Ray time for the infinite lines, the hitbox time closest to it, then the ray time closest to that
+		VectorRegister s = VectorMin(VectorMax(VectorMultiply(VectorSubtract(VectorMultiply(b, f), VectorMultiply(c, e)), VectorReciprocalAccurate(Denominator)), Zero), One);
+		const VectorRegister t = VectorMin(VectorMax(VectorMultiply(VectorMultiplyAdd(b, s, f), VectorReciprocalAccurate(VectorMax(e, Tiny))), Zero), One);
+		s = VectorMin(VectorMax(VectorMultiply(VectorSubtract(VectorMultiply(b, t), c), InvDLengthSquared), Zero), One);
+
+		const VectorRegister CX = VectorSubtract(VectorMultiplyAdd(DX, s, RX), VectorMultiply(LaneEX, t));
+		const VectorRegister CY = VectorSubtract(VectorMultiplyAdd(DY, s, RY), VectorMultiply(LaneEY, t));
+		const VectorRegister CZ = VectorSubtract(VectorMultiplyAdd(DZ, s, RZ), VectorMultiply(LaneEZ, t));
+		const VectorRegister DistanceSquared = VectorMultiplyAdd(CX, CX, VectorMultiplyAdd(CY, CY, VectorMultiply(CZ, CZ)));
+
+		const int32 Hits = VectorMaskBits(VectorCompareGE(VectorLoadAligned(&RadiusSquared[Lane]), DistanceSquared));
+		if (Hits == 0) { continue; }
+
+		VectorStoreAligned(s, RayTimes);
+		VectorStoreAligned(DistanceSquared, DistancesSquared);
+
+		for (int32 Offset = 0; Offset < 4; ++Offset) {
+			if (!(Hits & (1 << Offset)) || LaneOwners[Lane + Offset] == IgnoredActor) { continue; }
+
+			// Back up from the closest point to where the ray enters, exact for spheres
+			const float Depth = FMath::Sqrt(FMath::Max(RadiusSquared[Lane + Offset] - DistancesSquared[Offset], 0.f));
+			const float Time = FMath::Max(RayTimes[Offset] - Depth / DLength, 0.f);
+
+			if (Time < NearestTime) {
+				NearestTime = Time;
+				NearestLane = Lane + Offset;
+			}
+		}
+	}
+
+	if (NearestLane == INDEX_NONE) { return false; }
+
+	const FVector Location = Start + D * NearestTime;
+	const FVector A(AX[NearestLane], AY[NearestLane], AZ[NearestLane]);
+	const FVector E(EX[NearestLane], EY[NearestLane], EZ[NearestLane]);
+	const float AxisTime = ELengthSquared[NearestLane] > SMALL_NUMBER
+		? FMath::Clamp(FVector::DotProduct(Location - A, E) / ELengthSquared[NearestLane], 0.f, 1.f)
+		: 0.f;
+
+	OutHit.Actor = LaneOwners[NearestLane];
+	OutHit.Component = LaneComponents[NearestLane];
+	OutHit.BoneName = Sources[NearestLane].SocketA;
+	OutHit.SurfaceType = Sources[NearestLane].SurfaceType;
+	OutHit.Location = Location;
+	OutHit.Normal = (Location - (A + E * AxisTime)).GetSafeNormal();
+	if (OutHit.Normal.IsZero()) {
+		OutHit.Normal = -D / DLength;
+	}
+	OutHit.Time = NearestTime;
+	return true;
+}
+
+void ASHitboxRegistry::RunBenchmark(UWorld* World, int32 NrOfRays, FOutputDevice& Ar) {
+	auto Registry = Get(World);
+	if (!Registry) { return; }
+
+	Registry->Refresh();
+
+	TArray<FVector> Targets;
+	for (int32 Lane = 0; Lane < Registry->AX.Num(); ++Lane) {
+		if (Registry->RadiusSquared[Lane] >= 0.f) {
+			Targets.Add(FVector(Registry->AX[Lane], Registry->AY[Lane], Registry->AZ[Lane]) + 0.5f * FVector(Registry->EX[Lane], Registry->EY[Lane], Registry->EZ[Lane]));
+		}
+	}
+
+	if (Targets.Num() == 0) {
+		Ar.Log(TEXT("COOP.BenchHitboxTraces needs pawns in the world"));
+		return;
+	}
+
+	// The same rays for both, from all around and aimed near a random hitbox
+	FRandomStream Random(0x48697442);
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	Starts.Reserve(NrOfRays);
+	Ends.Reserve(NrOfRays);
+
+	for (int32 Index = 0; Index < NrOfRays; ++Index) {
+		const FVector Target = Targets[Random.RandHelper(Targets.Num())] + Random.VRand() * Random.FRandRange(0.f, 60.f);
+		const FVector Direction = Random.VRand();
+		Starts.Add(Target - Direction * Random.FRandRange(1000.f, 3000.f));
+		Ends.Add(Target + Direction * 1000.f);
+	}
+
+	int32 HitboxHits = 0;
+	double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < NrOfRays; ++Index) {
+		FSHitboxHit Hit;
+		HitboxHits += Registry->Raycast(Starts[Index], Ends[Index], nullptr, Hit) ? 1 : 0;
+	}
+
+	const double HitboxTime = FPlatformTime::Seconds() - StartTime;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(WeaponTrace), false);
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	int32 TraceHits = 0;
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < NrOfRays; ++Index) {
+		FHitResult Hit;
+		TraceHits += World->LineTraceSingleByChannel(Hit, Starts[Index], Ends[Index], COLLISION_WEAPON, QueryParams) ? 1 : 0;
+	}
+
+	const double TraceTime = FPlatformTime::Seconds() - StartTime;
+
+	Ar.Logf(TEXT("%d rays at %d hitboxes: hitbox raycast %.0f rays/s (%d hits), LineTraceSingleByChannel %.0f rays/s (%d hits, includes level geometry)"),
+		NrOfRays, Targets.Num(), NrOfRays / FMath::Max(HitboxTime, 1e-9), HitboxHits, NrOfRays / FMath::Max(TraceTime, 1e-9), TraceHits);
+}
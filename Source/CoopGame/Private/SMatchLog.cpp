@@ -0,0 +1,464 @@
+#include "SMatchLog.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+DECLARE_CYCLE_STAT(TEXT("Write Match Log"), STAT_WriteMatchLog, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Match Log Events"), STAT_MatchLogEvents, STATGROUP_CoopGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Match Log Events Dropped"), STAT_MatchLogEventsDropped, STATGROUP_CoopGame);
+
+static int32 MatchLogEnabled = 1;
+FAutoConsoleVariableRef CVARMatchLogEnabled(
+	TEXT("COOP.MatchLog"),
+	MatchLogEnabled,
+	TEXT("Write kills, damage, heals, wave changes, score and spawns to Saved/Logs/MatchLog-<time>.bin"),
+	ECVF_Default);
+
+static int32 MatchLogMaxFileMB = 16;
+FAutoConsoleVariableRef CVARMatchLogMaxFileMB(
+	TEXT("COOP.MatchLogMaxFileMB"),
+	MatchLogMaxFileMB,
+	TEXT("Size in MB at which the match log moves on to a new file"),
+	ECVF_Default);
+
+static int32 MatchLogMaxFiles = 10;
+FAutoConsoleVariableRef CVARMatchLogMaxFiles(
+	TEXT("COOP.MatchLogMaxFiles"),
+	MatchLogMaxFiles,
+	TEXT("Match log files kept in Saved/Logs, the oldest are deleted when a new one starts. 0 keeps them all"),
+	ECVF_Default);
+
+static float MatchLogFlushSeconds = 2.f;
+FAutoConsoleVariableRef CVARMatchLogFlushSeconds(
+	TEXT("COOP.MatchLogFlushSeconds"),
+	MatchLogFlushSeconds,
+	TEXT("Longest time events wait in memory before the match log writes them out, in a smaller block"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice MatchLogToCsvCommand(
+	TEXT("COOP.MatchLogToCsv"),
+	TEXT("Close the current match log and convert it to CSV next to it. Optional argument: the match log file to convert instead"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		FString FileName;
+		if (Args.Num() > 0) {
+			FileName = Args[0];
+		} else {
+			FSMatchLog::Get().Shutdown();
+
+			// Names start with their creation time, so the last one is the newest
+			TArray<FString> FileNames;
+			IFileManager::Get().FindFiles(FileNames, *(FPaths::ProjectLogDir() / TEXT("MatchLog-*.bin")), true, false);
+			if (FileNames.Num() == 0) {
+				Ar.Log(TEXT("No match logs in Saved/Logs"));
+				return;
+			}
+			FileNames.Sort();
+			FileName = FPaths::ProjectLogDir() / FileNames.Last();
+		}
+
+		FSMatchLog::ConvertToCsv(FileName, FPaths::ChangeExtension(FileName, TEXT("csv")), Ar);
+	}));
+
+static const uint32 MatchLogMagic = 0x474F4C43;
+static const uint32 MatchLogVersion = 1;
+
+// Uncompressed size at which the writer compresses a block and writes it out
+static const int32 MatchLogBlockSize = 64 * 1024;
+
+static const TCHAR* GetEventName(ESMatchEvent Type) {
+	switch (Type) {
+	case ESMatchEvent::Name: return TEXT("Name");
+	case ESMatchEvent::Kill: return TEXT("Kill");
+	case ESMatchEvent::Damage: return TEXT("Damage");
+	case ESMatchEvent::Heal: return TEXT("Heal");
+	case ESMatchEvent::WaveState: return TEXT("WaveState");
+	case ESMatchEvent::Score: return TEXT("Score");
+	case ESMatchEvent::Spawn: return TEXT("Spawn");
+	default: return TEXT("Unknown");
+	}
+}
+
+// Player names can hold anything, fields with a separator, quote or line break are quoted with the quotes doubled
+static FString EscapeCsv(const FString& Field) {
+	if (!Field.Contains(TEXT(",")) && !Field.Contains(TEXT("\"")) && !Field.Contains(TEXT("\n")) && !Field.Contains(TEXT("\r"))) {
+		return Field;
+	}
+
+	return TEXT("\"") + Field.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+}
+
+FArchive& operator<<(FArchive& Ar, FSMatchLogRecord& Record) {
+	uint8 Type = (uint8)Record.Type;
+	Ar << Type << Record.Arg << Record.World << Record.Time << Record.Subject;
+	Record.Type = (ESMatchEvent)Type;
+
+	// Names are written out as text, ids only mean something within the process
+	if (Record.Type == ESMatchEvent::Name) {
+		FString Text = Ar.IsLoading() ? FString() : Record.Name.ToString();
+		Ar << Text;
+		if (Ar.IsLoading()) {
+			Record.Name = FName(*Text);
+		}
+	} else {
+		Ar << Record.Other << Record.Value;
+	}
+
+	return Ar;
+}
+
+FSMatchLog& FSMatchLog::Get() {
+	static FSMatchLog Instance;
+	return Instance;
+}
+
+FSMatchLog::FSMatchLog() : Queue(16 * 1024) {
+	Thread = nullptr;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	LastBlockTime = 0.0;
+	FileWriter = nullptr;
+}
+
+FSMatchLog::~FSMatchLog() {
+	Shutdown();
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+bool FSMatchLog::IsEnabled() {
+	return MatchLogEnabled > 0 && FPlatformProcess::SupportsMultithreading();
+}
+
+void FSMatchLog::LogKill(const AActor* Victim, const AActor* Killer) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::Kill;
+	Record.Subject = GetId(Victim);
+	Record.Other = GetId(Killer);
+	Enqueue(Record, Victim);
+}
+
+void FSMatchLog::LogDamage(const AActor* Victim, const AActor* DamageCauser, float Damage) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::Damage;
+	Record.Subject = GetId(Victim);
+	Record.Other = GetId(DamageCauser);
+	Record.Value = Damage;
+	Enqueue(Record, Victim);
+}
+
+void FSMatchLog::LogHeal(const AActor* Target, float HealAmount) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::Heal;
+	Record.Subject = GetId(Target);
+	Record.Value = HealAmount;
+	Enqueue(Record, Target);
+}
+
+void FSMatchLog::LogWaveState(UWorld* World, uint8 WaveState, int32 WaveCount) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::WaveState;
+	Record.Arg = WaveState;
+	Record.Value = (float)WaveCount;
+	Enqueue(Record, World);
+}
+
+void FSMatchLog::LogScore(const AActor* PlayerState, float ScoreDelta) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::Score;
+	Record.Subject = GetId(PlayerState);
+	Record.Value = ScoreDelta;
+	Enqueue(Record, PlayerState);
+}
+
+void FSMatchLog::LogSpawn(const AActor* Spawned, bool bFromPool) {
+	if (!IsEnabled()) { return; }
+
+	FSMatchLogRecord Record;
+	Record.Type = ESMatchEvent::Spawn;
+	Record.Arg = bFromPool ? 1 : 0;
+	Record.Subject = GetId(Spawned);
+	Enqueue(Record, Spawned);
+}
+
+uint32 FSMatchLog::GetId(const UObject* Object) {
+	if (!Object) { return 0; }
+
+	// Unique ids are reused once an object is garbage collected, so the name is checked as well
+	auto PlayerState = Cast<APlayerState>(Object);
+	const FName Name = PlayerState ? FName(*PlayerState->GetPlayerName()) : Object->GetFName();
+	const uint32 Id = Object->GetUniqueID() + 1;
+
+	const FName* KnownName = NamedIds.Find(Id);
+	if (!KnownName || *KnownName != Name) {
+		FSMatchLogRecord Record;
+		Record.Type = ESMatchEvent::Name;
+		Record.Subject = Id;
+		Record.Name = Name;
+
+		// Tried again next time if the queue is full
+		if (Enqueue(Record, nullptr)) {
+			NamedIds.Add(Id, Name);
+		}
+	}
+
+	return Id;
+}
+
+bool FSMatchLog::Enqueue(FSMatchLogRecord& Record, const UObject* WorldContext) {
+	if (Record.Type != ESMatchEvent::Name) {
+		UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
+		Record.World = GetId(World);
+		Record.Time = World ? World->TimeSeconds : 0.f;
+	}
+
+	if (!Thread) {
+		bStopping = false;
+		Thread = FRunnableThread::Create(this, TEXT("CoopMatchLogWriter"), 0, TPri_BelowNormal);
+	}
+
+	if (!Queue.Enqueue(Record)) {
+		INC_DWORD_STAT(STAT_MatchLogEventsDropped);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_MatchLogEvents);
+	return true;
+}
+
+void FSMatchLog::Stop() {
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FSMatchLog::Shutdown() {
+	// Off the member first, deleting the thread calls Stop again through Kill
+	FRunnableThread* StoppingThread = Thread;
+	Thread = nullptr;
+	if (!StoppingThread) { return; }
+
+	StoppingThread->Kill(true);
+	delete StoppingThread;
+}
+
+uint32 FSMatchLog::Run() {
+	LastBlockTime = FPlatformTime::Seconds();
+
+	while (!bStopping) {
+		WakeEvent->Wait(50);
+		Drain(false);
+	}
+
+	Drain(true);
+	CloseFile();
+
+	return 0;
+}
+
+void FSMatchLog::Drain(bool bFlushBlock) {
+	FMemoryWriter Writer(Block, false, true);
+
+	FSMatchLogRecord Record;
+	while (Queue.Dequeue(Record)) {
+		if (Record.Type == ESMatchEvent::Name) {
+			FileNames.Add(Record.Subject, Record.Name);
+		}
+
+		Writer << Record;
+
+		if (Block.Num() >= MatchLogBlockSize) {
+			WriteBlock();
+			Writer.Seek(0);
+		}
+	}
+
+	if (Block.Num() > 0 && (bFlushBlock || FPlatformTime::Seconds() - LastBlockTime >= MatchLogFlushSeconds)) {
+		WriteBlock();
+	}
+}
+
+void FSMatchLog::WriteBlock() {
+	SCOPE_CYCLE_COUNTER(STAT_WriteMatchLog);
+
+	if (!FileWriter) {
+		OpenFile();
+	}
+
+	if (FileWriter) {
+		int32 UncompressedSize = Block.Num();
+		int32 CompressedSize = FCompression::CompressMemoryBound(COMPRESS_ZLIB, UncompressedSize);
+		CompressedBlock.SetNumUninitialized(CompressedSize);
+
+		// 0 marks a block stored as is
+		if (!FCompression::CompressMemory(COMPRESS_ZLIB, CompressedBlock.GetData(), CompressedSize, Block.GetData(), UncompressedSize)) {
+			CompressedSize = 0;
+		}
+
+		*FileWriter << UncompressedSize << CompressedSize;
+		if (CompressedSize > 0) {
+			FileWriter->Serialize(CompressedBlock.GetData(), CompressedSize);
+		} else {
+			FileWriter->Serialize(Block.GetData(), UncompressedSize);
+		}
+		FileWriter->Flush();
+
+		if (FileWriter->Tell() >= (int64)MatchLogMaxFileMB * 1024 * 1024) {
+			CloseFile();
+		}
+	}
+
+	Block.Reset();
+	LastBlockTime = FPlatformTime::Seconds();
+}
+
+void FSMatchLog::OpenFile() {
+	const FString Directory = FPaths::ProjectLogDir();
+
+	if (MatchLogMaxFiles > 0) {
+		TArray<FString> OldFiles;
+		IFileManager::Get().FindFiles(OldFiles, *(Directory / TEXT("MatchLog-*.bin")), true, false);
+		OldFiles.Sort();
+
+		for (int32 Index = 0; Index <= OldFiles.Num() - MatchLogMaxFiles; ++Index) {
+			IFileManager::Get().Delete(*(Directory / OldFiles[Index]));
+		}
+	}
+
+	const FString FileName = Directory / FString::Printf(TEXT("MatchLog-%s.bin"), *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S.%s")));
+	FileWriter = IFileManager::Get().CreateFileWriter(*FileName);
+	if (!FileWriter) {
+		UE_LOG(LogCoopGame, Warning, TEXT("Couldn't open match log %s"), *FileName);
+		return;
+	}
+
+	uint32 Magic = MatchLogMagic;
+	uint32 Version = MatchLogVersion;
+	*FileWriter << Magic << Version;
+
+	// Every name seen so far goes first, so rotated files can be converted on their own
+	if (FileNames.Num() > 0) {
+		TArray<uint8> Pending;
+		Swap(Pending, Block);
+
+		FMemoryWriter Writer(Block);
+		for (const auto& Pair : FileNames) {
+			FSMatchLogRecord Record;
+			Record.Type = ESMatchEvent::Name;
+			Record.Subject = Pair.Key;
+			Record.Name = Pair.Value;
+			Writer << Record;
+		}
+		WriteBlock();
+
+		Swap(Pending, Block);
+	}
+}
+
+void FSMatchLog::CloseFile() {
+	if (!FileWriter) { return; }
+
+	FileWriter->Close();
+	delete FileWriter;
+	FileWriter = nullptr;
+}
+
+bool FSMatchLog::ConvertToCsv(const FString& InFileName, const FString& OutFileName, FOutputDevice& Ar) {
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFileName));
+	if (!Reader) {
+		Ar.Logf(TEXT("Couldn't open %s"), *InFileName);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != MatchLogMagic || Version != MatchLogVersion) {
+		Ar.Logf(TEXT("%s isn't a match log this version can read"), *InFileName);
+		return false;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutFileName));
+	if (!Writer) {
+		Ar.Logf(TEXT("Couldn't write %s"), *OutFileName);
+		return false;
+	}
+
+	auto WriteLine = [&Writer](const FString& Line) {
+		FTCHARToUTF8 Utf8(*Line);
+		Writer->Serialize((void*)Utf8.Get(), Utf8.Length());
+	};
+	WriteLine(TEXT("World,Time,Event,Subject,Other,Value,Arg\n"));
+
+	auto WaveStateEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EWaveState"));
+	TMap<uint32, FString> Names;
+	auto GetName = [&Names](uint32 Id) {
+		const FString* Name = Names.Find(Id);
+		return Name ? EscapeCsv(*Name) : (Id ? FString::Printf(TEXT("#%u"), Id) : FString());
+	};
+
+	TArray<uint8> Compressed;
+	TArray<uint8> Uncompressed;
+	int32 NrOfEvents = 0;
+
+	while (Reader->Tell() + 8 <= Reader->TotalSize()) {
+		int32 UncompressedSize = 0;
+		int32 CompressedSize = 0;
+		*Reader << UncompressedSize << CompressedSize;
+
+		// The file may still be written to, or cut short by a crash
+		const int32 StoredSize = CompressedSize > 0 ? CompressedSize : UncompressedSize;
+		if (UncompressedSize <= 0 || Reader->Tell() + StoredSize > Reader->TotalSize()) { break; }
+
+		Uncompressed.SetNumUninitialized(UncompressedSize);
+		if (CompressedSize > 0) {
+			Compressed.SetNumUninitialized(CompressedSize);
+			Reader->Serialize(Compressed.GetData(), CompressedSize);
+			if (!FCompression::UncompressMemory(COMPRESS_ZLIB, Uncompressed.GetData(), UncompressedSize, Compressed.GetData(), CompressedSize)) { break; }
+		} else {
+			Reader->Serialize(Uncompressed.GetData(), UncompressedSize);
+		}
+
+		// A damaged block stops at the first record that doesn't read, rather than running past the end
+		FMemoryReader BlockReader(Uncompressed);
+		while (!BlockReader.AtEnd()) {
+			FSMatchLogRecord Record;
+			BlockReader << Record;
+			if (BlockReader.IsError()) { break; }
+
+			if (Record.Type == ESMatchEvent::Name) {
+				Names.Add(Record.Subject, Record.Name.ToString());
+				continue;
+			}
+
+			const FString Arg = Record.Type == ESMatchEvent::WaveState && WaveStateEnum
+				? EscapeCsv(WaveStateEnum->GetNameStringByValue(Record.Arg))
+				: FString::FromInt(Record.Arg);
+
+			WriteLine(FString::Printf(TEXT("%s,%.3f,%s,%s,%s,%g,%s\n"), *GetName(Record.World), Record.Time, GetEventName(Record.Type),
+				*GetName(Record.Subject), *GetName(Record.Other), Record.Value, *Arg));
+			NrOfEvents++;
+		}
+	}
+
+	Writer->Close();
+	Ar.Logf(TEXT("Wrote %d events from %s to %s"), NrOfEvents, *InFileName, *OutFileName);
+	return true;
+}
@@ -0,0 +1,42 @@
+#include "SMatchLogToCsvCommandlet.h"
+#include "SMatchLog.h"
+#include "CoopGame.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+USMatchLogToCsvCommandlet::USMatchLogToCsvCommandlet() {
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USMatchLogToCsvCommandlet::Main(const FString& Params) {
+	FString InPath;
+	if (!FParse::Value(*Params, TEXT("In="), InPath)) {
+		UE_LOG(LogCoopGame, Error, TEXT("Usage: -run=SMatchLogToCsv -In=<file or directory> [-Out=<file>]"));
+		return 1;
+	}
+
+	if (IFileManager::Get().DirectoryExists(*InPath)) {
+		TArray<FString> FileNames;
+		IFileManager::Get().FindFiles(FileNames, *(InPath / TEXT("MatchLog-*.bin")), true, false);
+
+		int32 NrOfFailures = 0;
+		for (const FString& FileName : FileNames) {
+			const FString FullName = InPath / FileName;
+			if (!FSMatchLog::ConvertToCsv(FullName, FPaths::ChangeExtension(FullName, TEXT("csv")), *GLog)) {
+				NrOfFailures++;
+			}
+		}
+		return NrOfFailures > 0 ? 1 : 0;
+	}
+
+	FString OutPath;
+	if (!FParse::Value(*Params, TEXT("Out="), OutPath)) {
+		OutPath = FPaths::ChangeExtension(InPath, TEXT("csv"));
+	}
+
+	return FSMatchLog::ConvertToCsv(InPath, OutPath, *GLog) ? 0 : 1;
+}
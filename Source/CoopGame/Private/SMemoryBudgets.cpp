@@ -0,0 +1,263 @@
+#include "SMemoryBudgets.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "AI/STrackerBot.h"
+#include "SBotRenderer.h"
+#include "SBotAvoidance.h"
+#include "SBotDecisions.h"
+#include "SBotMovementReplicator.h"
+#include "SProjectileManager.h"
+#include "SEventBus.h"
+#include "SWeapon.h"
+#include "STraceBatcher.h"
+#include "SHitboxRegistry.h"
+#include "SCharacter.h"
+#include "SPickupActor.h"
+#include "SPowerupActor.h"
+#include "SEffectProcessor.h"
+#include "SNavObstacleManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
+#include "HAL/PlatformMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Measure Memory Budgets"), STAT_MeasureMemoryBudgets, STATGROUP_CoopGame);
+
+static FString MemoryBudgets = TEXT("Bots=64,Navigation=8,Projectiles=8,Events=1,Replication=4,Weapons=16,Characters=32,Pickups=4,Effects=32");
+FAutoConsoleVariableRef CVARMemoryBudgets(
+	TEXT("COOP.MemoryBudgets"),
+	MemoryBudgets,
+	TEXT("Per category memory budgets in MB for each game world, as Category=MB pairs separated by commas. Categories left out have no budget"),
+	ECVF_Default);
+
+static float MemoryBudgetInterval = 10.f;
+FAutoConsoleVariableRef CVARMemoryBudgetInterval(
+	TEXT("COOP.MemoryBudgetInterval"),
+	MemoryBudgetInterval,
+	TEXT("Seconds between memory budget checks. 0 turns the checks off, COOP.DumpMemory still works"),
+	ECVF_Default);
+
+static int32 MemoryBudgetObjectsPerFrame = 16;
+FAutoConsoleVariableRef CVARMemoryBudgetObjectsPerFrame(
+	TEXT("COOP.MemoryBudgetObjectsPerFrame"),
+	MemoryBudgetObjectsPerFrame,
+	TEXT("Actors and emitters a memory budget check counts each frame until it has been through the whole world"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpMemoryCommand(
+	TEXT("COOP.DumpMemory"),
+	TEXT("Log how much memory bots, navigation, weapons, characters, pickups, effects and the game's managers hold in this world, against COOP.MemoryBudgets"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		ASMemoryBudgets::Dump(World, Ar);
+	}));
+
+static int32 GetTagIndex(ESMemoryTag Tag) {
+	return (int32)Tag - (int32)ESMemoryTag::Bots;
+}
+
+// Budget in bytes of every category, 0 for no budget
+static void ParseBudgets(int64 OutBudgets[NrOfMemoryTags]) {
+	FMemory::Memzero(OutBudgets, sizeof(int64) * NrOfMemoryTags);
+
+	TArray<FString> Entries;
+	MemoryBudgets.ParseIntoArray(Entries, TEXT(","));
+
+	for (const FString& Entry : Entries) {
+		FString Name;
+		FString Value;
+		if (!Entry.Split(TEXT("="), &Name, &Value)) { continue; }
+
+		Name.TrimStartAndEndInline();
+		for (int32 Index = 0; Index < NrOfMemoryTags; ++Index) {
+			if (Name == GetMemoryTagName(ESMemoryTag((int32)ESMemoryTag::Bots + Index))) {
+				OutBudgets[Index] = int64(FCString::Atof(*Value) * 1024.0 * 1024.0);
+			}
+		}
+	}
+}
+
+// INDEX_NONE for actors that aren't part of any category
+static int32 GetActorTagIndex(const AActor* Actor) {
+	if (Actor->IsA<ASTrackerBot>() || Actor->IsA<ASBotRenderer>() || Actor->IsA<ASBotAvoidance>() || Actor->IsA<ASBotDecisions>()) {
+		return GetTagIndex(ESMemoryTag::Bots);
+	}
+	if (Actor->IsA<ASWeapon>() || Actor->IsA<ASTraceBatcher>() || Actor->IsA<ASHitboxRegistry>()) {
+		return GetTagIndex(ESMemoryTag::Weapons);
+	}
+	if (Actor->IsA<ASCharacter>()) { return GetTagIndex(ESMemoryTag::Characters); }
+	if (Actor->IsA<ASPickupActor>() || Actor->IsA<ASPowerupActor>() || Actor->IsA<ASEffectProcessor>()) { return GetTagIndex(ESMemoryTag::Pickups); }
+	if (Actor->IsA<ASProjectileManager>()) { return GetTagIndex(ESMemoryTag::Projectiles); }
+	if (Actor->IsA<ASEventBus>()) { return GetTagIndex(ESMemoryTag::Events); }
+	if (Actor->IsA<ASBotMovementReplicator>()) { return GetTagIndex(ESMemoryTag::Replication); }
+	if (Actor->IsA<ASNavObstacleManager>()) { return GetTagIndex(ESMemoryTag::Navigation); }
+
+	return INDEX_NONE;
+}
+
+static int64 CountObjectBytes(UObject* Object) {
+	FArchiveCountMem Count(Object);
+	return Count.GetMax() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+}
+
+// Actors that belong to a category and every emitter in the world, in the order they're counted
+static void GatherObjects(UWorld* World, TArray<TWeakObjectPtr<UObject>>& OutObjects) {
+	for (TActorIterator<AActor> It(World); It; ++It) {
+		if (GetActorTagIndex(*It) != INDEX_NONE) {
+			OutObjects.Add(*It);
+		}
+	}
+
+	// Spawned at a location they belong to the world rather than an actor, so go through every emitter
+	ForEachObjectOfClass(UParticleSystemComponent::StaticClass(), [&OutObjects, World](UObject* Object) {
+		if (Object->IsPendingKill() || Object->GetWorld() != World) { return; }
+
+		OutObjects.Add(Object);
+	});
+}
+
+static void CountObject(UObject* Object, FSMemoryReport& Report) {
+	if (Object->IsA<UParticleSystemComponent>()) {
+		const int32 EffectsIndex = GetTagIndex(ESMemoryTag::Effects);
+		Report.Bytes[EffectsIndex] += CountObjectBytes(Object);
+		Report.Objects[EffectsIndex]++;
+		return;
+	}
+
+	auto Actor = Cast<AActor>(Object);
+	const int32 Index = Actor ? GetActorTagIndex(Actor) : INDEX_NONE;
+	if (Index == INDEX_NONE) { return; }
+
+	Report.Bytes[Index] += CountObjectBytes(Actor);
+	Report.Objects[Index]++;
+
+	// Components, and objects created with the actor as outer such as the bot renderer's MIDs
+	ForEachObjectWithOuter(Actor, [&Report, Index](UObject* Inner) {
+		// Counted with the effects
+		if (Inner->IsA<UParticleSystemComponent>()) { return; }
+
+		Report.Bytes[Index] += CountObjectBytes(Inner);
+		Report.Objects[Index]++;
+	}, true);
+
+	if (auto Bot = Cast<ASTrackerBot>(Actor)) {
+		if (const SIZE_T PathBytes = Bot->GetPathAllocatedSize()) {
+			const int32 NavigationIndex = GetTagIndex(ESMemoryTag::Navigation);
+			Report.Bytes[NavigationIndex] += PathBytes;
+			Report.Objects[NavigationIndex]++;
+		}
+	}
+}
+
+ASMemoryBudgets::ASMemoryBudgets() {
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickInterval = MemoryBudgetInterval;
+
+	SetReplicates(false);
+
+	FMemory::Memzero(bOverBudget, sizeof(bOverBudget));
+	NextPendingObject = 0;
+	FMemory::Memzero(PendingReport);
+}
+
+ASMemoryBudgets* ASMemoryBudgets::Get(UWorld* World) {
+	return GetWorldManager<ASMemoryBudgets>(World);
+}
+
+void ASMemoryBudgets::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	if (MemoryBudgetInterval <= 0.f) {
+		PendingObjects.Reset();
+		SetActorTickInterval(1.f);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MeasureMemoryBudgets);
+
+	if (PendingObjects.Num() == 0) {
+		GatherObjects(GetWorld(), PendingObjects);
+		NextPendingObject = 0;
+		FMemory::Memzero(PendingReport);
+
+		// Every frame until the check is done
+		SetActorTickInterval(0.f);
+	}
+
+	// Objects destroyed since the check started are skipped
+	const int32 LastObject = FMath::Min(NextPendingObject + FMath::Max(MemoryBudgetObjectsPerFrame, 1), PendingObjects.Num());
+	for (; NextPendingObject < LastObject; ++NextPendingObject) {
+		if (UObject* Object = PendingObjects[NextPendingObject].Get()) {
+			CountObject(Object, PendingReport);
+		}
+	}
+
+	if (NextPendingObject < PendingObjects.Num()) { return; }
+
+	PendingObjects.Reset();
+	SetActorTickInterval(FMath::Max(MemoryBudgetInterval, 1.f));
+
+	CheckBudgets(PendingReport);
+}
+
+void ASMemoryBudgets::CheckBudgets(const FSMemoryReport& Report) {
+	int64 Budgets[NrOfMemoryTags];
+	ParseBudgets(Budgets);
+
+	for (int32 Index = 0; Index < NrOfMemoryTags; ++Index) {
+		const bool bOver = Budgets[Index] > 0 && Report.Bytes[Index] > Budgets[Index];
+		const TCHAR* Name = GetMemoryTagName(ESMemoryTag((int32)ESMemoryTag::Bots + Index));
+
+		// Once when going over and once when back under, not every check
+		if (bOver && !bOverBudget[Index]) {
+			UE_LOG(LogCoopGame, Warning, TEXT("%s: %s over its memory budget, %.1f of %.1f MB in %d objects"), *GetWorld()->GetName(), Name,
+				Report.Bytes[Index] / (1024.f * 1024.f), Budgets[Index] / (1024.f * 1024.f), Report.Objects[Index]);
+		} else if (!bOver && bOverBudget[Index]) {
+			UE_LOG(LogCoopGame, Log, TEXT("%s: %s back under its memory budget, %.1f MB"), *GetWorld()->GetName(), Name, Report.Bytes[Index] / (1024.f * 1024.f));
+		}
+
+		bOverBudget[Index] = bOver;
+	}
+}
+
+void ASMemoryBudgets::Measure(UWorld* World, FSMemoryReport& OutReport) {
+	FMemory::Memzero(OutReport);
+	if (!World) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_MeasureMemoryBudgets);
+
+	TArray<TWeakObjectPtr<UObject>> Objects;
+	GatherObjects(World, Objects);
+
+	for (const TWeakObjectPtr<UObject>& Object : Objects) {
+		CountObject(Object.Get(), OutReport);
+	}
+}
+
+void ASMemoryBudgets::Dump(UWorld* World, FOutputDevice& Ar) {
+	if (!World) { return; }
+
+	FSMemoryReport Report;
+	Measure(World, Report);
+
+	int64 Budgets[NrOfMemoryTags];
+	ParseBudgets(Budgets);
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	Ar.Logf(TEXT("CoopGame memory in %s, process resident %.1f MB"), *World->GetName(), MemoryStats.UsedPhysical / (1024.f * 1024.f));
+
+	int64 TotalBytes = 0;
+	for (int32 Index = 0; Index < NrOfMemoryTags; ++Index) {
+		const FString Budget = Budgets[Index] > 0
+			? FString::Printf(TEXT("%8.2f MB (%3.0f%%)"), Budgets[Index] / (1024.f * 1024.f), 100.0 * Report.Bytes[Index] / Budgets[Index])
+			: FString(TEXT("       no budget"));
+
+		Ar.Logf(TEXT("  %-12s %6d objects %8.2f MB  budget %s"), GetMemoryTagName(ESMemoryTag((int32)ESMemoryTag::Bots + Index)),
+			Report.Objects[Index], Report.Bytes[Index] / (1024.f * 1024.f), *Budget);
+
+		TotalBytes += Report.Bytes[Index];
+	}
+
+	Ar.Logf(TEXT("  %-12s %23.2f MB"), TEXT("Total"), TotalBytes / (1024.f * 1024.f));
+}
@@ -0,0 +1,45 @@
+#include "SMemoryTags.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Bots"), STAT_CoopBotsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Navigation"), STAT_CoopNavigationLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Projectiles"), STAT_CoopProjectilesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Events"), STAT_CoopEventsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Replication"), STAT_CoopReplicationLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Weapons"), STAT_CoopWeaponsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Characters"), STAT_CoopCharactersLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Pickups"), STAT_CoopPickupsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Coop Effects"), STAT_CoopEffectsLLM, STATGROUP_LLMFULL);
+
+#endif
+
+const TCHAR* GetMemoryTagName(ESMemoryTag Tag) {
+	switch (Tag) {
+	case ESMemoryTag::Bots: return TEXT("Bots");
+	case ESMemoryTag::Navigation: return TEXT("Navigation");
+	case ESMemoryTag::Projectiles: return TEXT("Projectiles");
+	case ESMemoryTag::Events: return TEXT("Events");
+	case ESMemoryTag::Replication: return TEXT("Replication");
+	case ESMemoryTag::Weapons: return TEXT("Weapons");
+	case ESMemoryTag::Characters: return TEXT("Characters");
+	case ESMemoryTag::Pickups: return TEXT("Pickups");
+	case ESMemoryTag::Effects: return TEXT("Effects");
+	default: return TEXT("?");
+	}
+}
+
+void RegisterMemoryTags() {
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Bots, TEXT("CoopBots"), GET_STATFNAME(STAT_CoopBotsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Navigation, TEXT("CoopNavigation"), GET_STATFNAME(STAT_CoopNavigationLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Projectiles, TEXT("CoopProjectiles"), GET_STATFNAME(STAT_CoopProjectilesLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Events, TEXT("CoopEvents"), GET_STATFNAME(STAT_CoopEventsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Replication, TEXT("CoopReplication"), GET_STATFNAME(STAT_CoopReplicationLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Weapons, TEXT("CoopWeapons"), GET_STATFNAME(STAT_CoopWeaponsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Characters, TEXT("CoopCharacters"), GET_STATFNAME(STAT_CoopCharactersLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Pickups, TEXT("CoopPickups"), GET_STATFNAME(STAT_CoopPickupsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)ESMemoryTag::Effects, TEXT("CoopEffects"), GET_STATFNAME(STAT_CoopEffectsLLM), NAME_None);
+#endif
+}
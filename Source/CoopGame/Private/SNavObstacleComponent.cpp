@@ -0,0 +1,88 @@
+#include "SNavObstacleComponent.h"
+#include "SNavObstacleManager.h"
+#include "SWorldManager.h"
+#include "NavigationOctree.h"
+#include "AI/NavigationModifier.h"
+#include "NavAreas/NavArea_Obstacle.h"
+#include "Components/PrimitiveComponent.h"
+
+// Turning further than this moves the footprint even if the prop stayed in place
+static const float CommitAngleThreshold = FMath::DegreesToRadians(15.f);
+
+USNavObstacleComponent::USNavObstacleComponent() {
+	AreaClass = UNavArea_Obstacle::StaticClass();
+	FailsafeExtent = FVector(50.f);
+
+	// The owner's meshes aren't in the navigation octree, so this can't be attached to them
+	bAttachToOwnersRoot = false;
+
+	LocalBounds = FBox(ForceInit);
+}
+
+USceneComponent* USNavObstacleComponent::GetTrackedComponent() const {
+	auto MyOwner = GetOwner();
+	return MyOwner ? MyOwner->GetRootComponent() : nullptr;
+}
+
+void USNavObstacleComponent::OnRegister() {
+	// Navigation asks for the bounds as soon as this registers
+	if (auto Root = GetTrackedComponent()) {
+		LocalBounds = Root->CalcBounds(FTransform::Identity).GetBox();
+		CommittedTransform = Root->GetComponentTransform();
+	}
+
+	if (!LocalBounds.IsValid) {
+		LocalBounds = FBox(-FailsafeExtent, FailsafeExtent);
+	}
+
+	Super::OnRegister();
+}
+
+void USNavObstacleComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	if (auto Manager = ASNavObstacleManager::Get(GetWorld())) {
+		Manager->AddObstacle(this);
+	}
+}
+
+void USNavObstacleComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	// Not worth spawning one while the world tears down
+	if (auto Manager = GetWorldManager<ASNavObstacleManager>(GetWorld(), false)) {
+		Manager->RemoveObstacle(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USNavObstacleComponent::CalcAndCacheBounds() const {
+	Bounds = LocalBounds.TransformBy(CommittedTransform);
+}
+
+void USNavObstacleComponent::GetNavigationData(FNavigationRelevantData& Data) const {
+	const FTransform BoxToWorld = FTransform(LocalBounds.GetCenter()) * CommittedTransform;
+
+	Data.Modifiers.Add(FAreaNavModifier(LocalBounds.GetExtent(), BoxToWorld, AreaClass).SetIncludeAgentHeight(true));
+}
+
+bool USNavObstacleComponent::NeedsCommit(float MoveThreshold) const {
+	auto Root = GetTrackedComponent();
+	if (!Root) { return false; }
+
+	const FTransform& Current = Root->GetComponentTransform();
+
+	return FVector::DistSquared(Current.GetLocation(), CommittedTransform.GetLocation()) > FMath::Square(MoveThreshold)
+		|| Current.GetRotation().AngularDistance(CommittedTransform.GetRotation()) > CommitAngleThreshold;
+}
+
+void USNavObstacleComponent::CommitTransform(FBox& OutOldBounds, FBox& OutNewBounds) {
+	OutOldBounds = LocalBounds.TransformBy(CommittedTransform);
+
+	if (auto Root = GetTrackedComponent()) {
+		CommittedTransform = Root->GetComponentTransform();
+	}
+
+	OutNewBounds = LocalBounds.TransformBy(CommittedTransform);
+
+	RefreshNavigationModifiers();
+}
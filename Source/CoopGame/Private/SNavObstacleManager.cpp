@@ -0,0 +1,147 @@
+#include "SNavObstacleManager.h"
+#include "SNavObstacleComponent.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Nav Obstacles"), STAT_UpdateNavObstacles, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Obstacles"), STAT_NavObstacles, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Obstacles Waiting"), STAT_NavObstaclesWaiting, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Tiles Dirtied Per Second"), STAT_NavTilesPerSecond, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Build Tasks"), STAT_NavBuildTasks, STATGROUP_CoopGame);
+
+static int32 NavObstacleBudget = 4;
+FAutoConsoleVariableRef CVARNavObstacleBudget(
+	TEXT("COOP.NavObstacleBudget"),
+	NavObstacleBudget,
+	TEXT("Most prop navigation footprints moved per second, each one rebuilds the navmesh tiles under its old and new footprint"),
+	ECVF_Default);
+
+static float NavObstacleSettleTime = 0.5f;
+FAutoConsoleVariableRef CVARNavObstacleSettleTime(
+	TEXT("COOP.NavObstacleSettleTime"),
+	NavObstacleSettleTime,
+	TEXT("Seconds a prop has to stay still before its navigation footprint follows it, so a tumbling prop rebuilds once"),
+	ECVF_Default);
+
+static float NavObstacleMoveThreshold = 50.f;
+FAutoConsoleVariableRef CVARNavObstacleMoveThreshold(
+	TEXT("COOP.NavObstacleMoveThreshold"),
+	NavObstacleMoveThreshold,
+	TEXT("How far a prop has to move from its navigation footprint before the footprint is moved"),
+	ECVF_Default);
+
+ASNavObstacleManager::ASNavObstacleManager() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Settling is measured in tenths of a second
+	PrimaryActorTick.TickInterval = 0.1f;
+
+	SetReplicates(false);
+
+	UpdateTokens = 0.f;
+	WindowTiles = 0;
+	StatWindowStart = 0.f;
+}
+
+ASNavObstacleManager* ASNavObstacleManager::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client) { return nullptr; }
+
+	return GetWorldManager<ASNavObstacleManager>(World);
+}
+
+void ASNavObstacleManager::AddObstacle(USNavObstacleComponent* Obstacle) {
+	if (!Obstacle || !Obstacle->GetOwner()) { return; }
+
+	RemoveObstacle(Obstacle);
+
+	FObstacle& Entry = Obstacles[Obstacles.AddDefaulted()];
+	Entry.Component = Obstacle;
+	Entry.LastLocation = Obstacle->GetOwner()->GetActorLocation();
+	Entry.LastMoveTime = GetWorld()->TimeSeconds;
+}
+
+void ASNavObstacleManager::RemoveObstacle(USNavObstacleComponent* Obstacle) {
+	Obstacles.RemoveAll([Obstacle](const FObstacle& Entry) { return Entry.Component == Obstacle; });
+}
+
+void ASNavObstacleManager::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_UpdateNavObstacles);
+
+	const float Now = GetWorld()->TimeSeconds;
+
+	// Never more saved up than one second's worth, so a quiet stretch can't turn into a burst
+	const float MaxTokens = FMath::Max((float)NavObstacleBudget, 1.f);
+	UpdateTokens = FMath::Min(UpdateTokens + NavObstacleBudget * DeltaSeconds, MaxTokens);
+
+	auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	auto NavMesh = NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+
+	TSet<FIntPoint> DirtyTiles;
+	int32 Waiting = 0;
+
+	for (int32 Index = 0; Index < Obstacles.Num();) {
+		FObstacle& Entry = Obstacles[Index];
+
+		USNavObstacleComponent* Obstacle = Entry.Component.Get();
+		if (!Obstacle || !Obstacle->GetOwner()) {
+			Obstacles.RemoveAt(Index, 1, false);
+			continue;
+		}
+		++Index;
+
+		// Still tumbling, wait for it to come to rest
+		const FVector Location = Obstacle->GetOwner()->GetActorLocation();
+		if (!Location.Equals(Entry.LastLocation, 1.f)) {
+			Entry.LastLocation = Location;
+			Entry.LastMoveTime = Now;
+		}
+		if (Now - Entry.LastMoveTime < NavObstacleSettleTime) { continue; }
+
+		if (!Obstacle->NeedsCommit(NavObstacleMoveThreshold)) { continue; }
+
+		if (UpdateTokens < 1.f) {
+			++Waiting;
+			continue;
+		}
+		UpdateTokens -= 1.f;
+
+		FBox OldBounds;
+		FBox NewBounds;
+		Obstacle->CommitTransform(OldBounds, NewBounds);
+
+		if (NavMesh) {
+			CollectTiles(OldBounds, NavMesh->TileSizeUU, DirtyTiles);
+			CollectTiles(NewBounds, NavMesh->TileSizeUU, DirtyTiles);
+		}
+	}
+
+	WindowTiles += DirtyTiles.Num();
+	if (Now - StatWindowStart >= 1.f) {
+		SET_DWORD_STAT(STAT_NavTilesPerSecond, WindowTiles);
+		WindowTiles = 0;
+		StatWindowStart = Now;
+	}
+
+	SET_DWORD_STAT(STAT_NavObstacles, Obstacles.Num());
+	SET_DWORD_STAT(STAT_NavObstaclesWaiting, Waiting);
+	SET_DWORD_STAT(STAT_NavBuildTasks, NavSys ? NavSys->GetNumRemainingBuildTasks() : 0);
+}
+
+void ASNavObstacleManager::CollectTiles(const FBox& Box, float TileSize, TSet<FIntPoint>& OutTiles) const {
+	if (!Box.IsValid || TileSize <= 0.f) { return; }
+
+	const int32 MinX = FMath::FloorToInt(Box.Min.X / TileSize);
+	const int32 MaxX = FMath::FloorToInt(Box.Max.X / TileSize);
+	const int32 MinY = FMath::FloorToInt(Box.Min.Y / TileSize);
+	const int32 MaxY = FMath::FloorToInt(Box.Max.Y / TileSize);
+
+	for (int32 X = MinX; X <= MaxX; ++X) {
+		for (int32 Y = MinY; Y <= MaxY; ++Y) {
+			OutTiles.Add(FIntPoint(X, Y));
+		}
+	}
+}
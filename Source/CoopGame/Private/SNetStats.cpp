@@ -0,0 +1,295 @@
+#include "SNetStats.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "UObject/CoreNet.h"
+#include "UObject/UnrealType.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+
+static int32 NetStatsEnabled = 0;
+FAutoConsoleVariableRef CVARNetStatsEnabled(
+	TEXT("COOP.NetStats"),
+	NetStatsEnabled,
+	TEXT("Attribute network bytes to CoopGame properties and RPCs"),
+	ECVF_Default);
+
+static int32 NetStatsOnScreen = 0;
+FAutoConsoleVariableRef CVARNetStatsOnScreen(
+	TEXT("COOP.NetStatsOnScreen"),
+	NetStatsOnScreen,
+	TEXT("Show per connection CoopGame network bytes on screen"),
+	ECVF_Default);
+
+static int32 NetStatsCSV = 0;
+FAutoConsoleVariableRef CVARNetStatsCSV(
+	TEXT("COOP.NetStatsCSV"),
+	NetStatsCSV,
+	TEXT("Append per second CoopGame network bytes to Saved/Profiling/NetStats-<time>.csv"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithOutputDevice DumpNetStatsCommand(
+	TEXT("COOP.DumpNetStats"),
+	TEXT("Log bytes per second and high-water marks of CoopGame properties and RPCs for every connection"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar) {
+		FSNetStats::Get().Dump(Ar);
+	}));
+
+// Object references go out as a NetGUID, which is usually already acknowledged and fits in a 32 bit handle
+static const int32 NetGUIDBits = 32;
+
+// Field header, function handle and bunch overhead of a single RPC
+static const int32 RPCHeaderBits = 48;
+
+// Replicated arrays send their element count ahead of the elements
+static const int32 ArrayCountBits = 16;
+
+static int32 MeasureBits(const UProperty* Property, const void* Data) {
+	if (auto StructProperty = Cast<UStructProperty>(Property)) {
+		if (!(StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative)) {
+			return FSNetStats::MeasureStructBits(StructProperty->Struct, Data);
+		}
+	}
+
+	// Arrays don't net serialize as a whole, that path is fatal, so every element is measured on its own
+	if (auto ArrayProperty = Cast<UArrayProperty>(Property)) {
+		FScriptArrayHelper Helper(ArrayProperty, Data);
+
+		int32 Bits = ArrayCountBits;
+		for (int32 Index = 0; Index < Helper.Num(); ++Index) {
+			Bits += MeasureBits(ArrayProperty->Inner, Helper.GetRawPtr(Index));
+		}
+		return Bits;
+	}
+
+	if (Property->IsA<UObjectPropertyBase>()) { return NetGUIDBits; }
+	if (Property->IsA<UBoolProperty>()) { return 1; }
+
+	FNetBitWriter Writer(nullptr, 256);
+	Property->NetSerializeItem(Writer, nullptr, const_cast<void*>(Data));
+
+	return Writer.GetNumBits();
+}
+
+static const AActor* GetOwningActor(const UObject* Object) {
+	if (auto Actor = Cast<AActor>(Object)) { return Actor; }
+
+	auto Component = Cast<UActorComponent>(Object);
+	return Component ? Component->GetOwner() : nullptr;
+}
+
+FSNetStats& FSNetStats::Get() {
+	static FSNetStats Instance;
+	return Instance;
+}
+
+FSNetStats::FSNetStats() {
+	CSVWriter = nullptr;
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FSNetStats::Roll), 1.f);
+}
+
+FSNetStats::~FSNetStats() {
+	Shutdown();
+}
+
+void FSNetStats::Shutdown() {
+	if (TickerHandle.IsValid()) {
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	if (CSVWriter) {
+		CSVWriter->Close();
+		delete CSVWriter;
+		CSVWriter = nullptr;
+	}
+}
+
+bool FSNetStats::IsEnabled() {
+	return NetStatsEnabled > 0;
+}
+
+int32 FSNetStats::MeasureStructBits(const UStruct* Struct, const void* Data) {
+	int32 Bits = 0;
+	for (TFieldIterator<UProperty> It(Struct); It; ++It) {
+		if (!(It->PropertyFlags & CPF_RepSkip)) {
+			Bits += MeasureBits(*It, It->ContainerPtrToValuePtr<void>(Data));
+		}
+	}
+	return Bits;
+}
+
+int32 FSNetStats::MeasurePropertyBits(const UObject* Object, FName PropertyName) {
+	if (!Object) { return 0; }
+
+	// Looked up by name once per class, this runs on every replicated change
+	TMap<FName, UProperty*>& ClassProperties = PropertyCache.FindOrAdd(Object->GetClass());
+	UProperty** CachedProperty = ClassProperties.Find(PropertyName);
+	UProperty* Property = CachedProperty ? *CachedProperty : ClassProperties.Add(PropertyName, Object->GetClass()->FindPropertyByName(PropertyName));
+	if (!Property) { return 0; }
+
+	return MeasureBits(Property, Property->ContainerPtrToValuePtr<void>(Object));
+}
+
+void FSNetStats::RecordPropertySent(const UObject* Object, FName PropertyName, bool bSkipOwner) {
+	if (!IsEnabled()) { return; }
+
+	auto Actor = const_cast<AActor*>(GetOwningActor(Object));
+	auto NetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+	if (!NetDriver || NetDriver->ClientConnections.Num() == 0) { return; }
+
+	const int32 Bits = MeasurePropertyBits(Object, PropertyName);
+	auto OwnerConnection = bSkipOwner ? Actor->GetNetConnection() : nullptr;
+
+	for (UNetConnection* Connection : NetDriver->ClientConnections) {
+		if (!Connection || Connection == OwnerConnection) { continue; }
+		if (!Connection->ActorChannels.Contains(Actor)) { continue; }
+
+		Record(Connection, PropertyName, Bits, false, true);
+	}
+}
+
+void FSNetStats::RecordPropertyReceived(const UObject* Object, FName PropertyName) {
+	if (!IsEnabled()) { return; }
+
+	auto Actor = GetOwningActor(Object);
+	auto NetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+	if (!NetDriver || !NetDriver->ServerConnection) { return; }
+
+	Record(NetDriver->ServerConnection, PropertyName, MeasurePropertyBits(Object, PropertyName), false, false);
+}
+
+void FSNetStats::RecordRPCSent(const AActor* Actor, FName FunctionName, int32 ParamBits) {
+	if (!IsEnabled() || !Actor) { return; }
+
+	auto Connection = Actor->GetNetConnection();
+	if (Connection) {
+		Record(Connection, FunctionName, RPCHeaderBits + ParamBits, true, true);
+	}
+}
+
+void FSNetStats::RecordRPCReceived(const AActor* Actor, FName FunctionName, int32 ParamBits) {
+	if (!IsEnabled() || !Actor) { return; }
+
+	auto Connection = Actor->GetNetConnection();
+	if (Connection) {
+		Record(Connection, FunctionName, RPCHeaderBits + ParamBits, true, false);
+	}
+}
+
+void FSNetStats::Record(UNetConnection* Connection, FName Name, int32 Bits, bool bIsRPC, bool bSent) {
+	FSConnectionNetStats* Stats = Connections.Find(Connection);
+	if (!Stats) {
+		Stats = &Connections.Add(Connection);
+		Stats->Name = Connection->LowLevelGetRemoteAddress(true);
+	}
+
+	FSNetStatEntry& Entry = (bSent ? Stats->Sent : Stats->Received).FindOrAdd(Name);
+	Entry.bIsRPC = bIsRPC;
+	Entry.CurrentBits += Bits;
+}
+
+bool FSNetStats::Roll(float DeltaTime) {
+	for (auto It = Connections.CreateIterator(); It; ++It) {
+		UNetConnection* Connection = It.Key().Get();
+		if (!Connection) {
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FSConnectionNetStats& Stats = It.Value();
+		Stats.InBytesPerSecond = Connection->InBytesPerSecond;
+		Stats.OutBytesPerSecond = Connection->OutBytesPerSecond;
+
+		for (auto* Entries : { &Stats.Sent, &Stats.Received }) {
+			for (auto& Pair : *Entries) {
+				FSNetStatEntry& Entry = Pair.Value;
+				Entry.LastSecondBytes = (Entry.CurrentBits + 7) / 8;
+				Entry.HighWaterBytes = FMath::Max(Entry.HighWaterBytes, Entry.LastSecondBytes);
+				Entry.TotalBytes += Entry.LastSecondBytes;
+				Entry.CurrentBits = 0;
+			}
+		}
+	}
+
+	WriteCSV(FPlatformTime::Seconds());
+
+	if (NetStatsOnScreen > 0 && GEngine) {
+		int32 MessageKey = 0x4E455400;
+		for (const auto& Pair : Connections) {
+			const FSConnectionNetStats& Stats = Pair.Value;
+			GEngine->AddOnScreenDebugMessage(MessageKey++, 1.1f, FColor::Cyan,
+				FString::Printf(TEXT("%s  in %d B/s  out %d B/s"), *Stats.Name, Stats.InBytesPerSecond, Stats.OutBytesPerSecond));
+
+			for (auto* Entries : { &Stats.Sent, &Stats.Received }) {
+				const TCHAR* Direction = Entries == &Stats.Sent ? TEXT("sent") : TEXT("recv");
+				for (const auto& EntryPair : *Entries) {
+					GEngine->AddOnScreenDebugMessage(MessageKey++, 1.1f, FColor::White,
+						FString::Printf(TEXT("    %s %s %d B/s (peak %d)"), Direction, *EntryPair.Key.ToString(),
+							EntryPair.Value.LastSecondBytes, EntryPair.Value.HighWaterBytes));
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FSNetStats::WriteCSV(double Time) {
+	if (NetStatsCSV <= 0) {
+		if (CSVWriter) {
+			CSVWriter->Close();
+			delete CSVWriter;
+			CSVWriter = nullptr;
+		}
+		return;
+	}
+
+	if (!CSVWriter) {
+		const FString FileName = FPaths::ProjectSavedDir() / TEXT("Profiling") / FString::Printf(TEXT("NetStats-%s.csv"), *FDateTime::Now().ToString());
+		CSVWriter = IFileManager::Get().CreateFileWriter(*FileName);
+		if (!CSVWriter) { return; }
+
+		FTCHARToUTF8 Header(TEXT("Time,Connection,Direction,Kind,Name,Bytes,HighWaterBytes,ConnectionInBytes,ConnectionOutBytes\n"));
+		CSVWriter->Serialize((void*)Header.Get(), Header.Length());
+	}
+
+	for (const auto& Pair : Connections) {
+		const FSConnectionNetStats& Stats = Pair.Value;
+
+		for (auto* Entries : { &Stats.Sent, &Stats.Received }) {
+			const TCHAR* Direction = Entries == &Stats.Sent ? TEXT("Sent") : TEXT("Received");
+			for (const auto& EntryPair : *Entries) {
+				const FSNetStatEntry& Entry = EntryPair.Value;
+				FTCHARToUTF8 Row(*FString::Printf(TEXT("%.3f,%s,%s,%s,%s,%d,%d,%d,%d\n"), Time, *Stats.Name, Direction,
+					Entry.bIsRPC ? TEXT("RPC") : TEXT("Property"), *EntryPair.Key.ToString(), Entry.LastSecondBytes, Entry.HighWaterBytes,
+					Stats.InBytesPerSecond, Stats.OutBytesPerSecond));
+				CSVWriter->Serialize((void*)Row.Get(), Row.Length());
+			}
+		}
+	}
+
+	CSVWriter->Flush();
+}
+
+void FSNetStats::Dump(FOutputDevice& Ar) const {
+	Ar.Logf(TEXT("CoopGame net stats for %d connection(s)"), Connections.Num());
+
+	for (const auto& Pair : Connections) {
+		const FSConnectionNetStats& Stats = Pair.Value;
+		Ar.Logf(TEXT("%s: in %d B/s, out %d B/s"), *Stats.Name, Stats.InBytesPerSecond, Stats.OutBytesPerSecond);
+
+		for (auto* Entries : { &Stats.Sent, &Stats.Received }) {
+			const TCHAR* Direction = Entries == &Stats.Sent ? TEXT("Sent") : TEXT("Received");
+			for (const auto& EntryPair : *Entries) {
+				const FSNetStatEntry& Entry = EntryPair.Value;
+				Ar.Logf(TEXT("  %-8s %-8s %-28s %6d B/s  peak %6d B/s  total %lld B"), Direction, Entry.bIsRPC ? TEXT("RPC") : TEXT("Property"),
+					*EntryPair.Key.ToString(), Entry.LastSecondBytes, Entry.HighWaterBytes, Entry.TotalBytes);
+			}
+		}
+	}
+}
@@ -3,9 +3,15 @@
 #include "SPickupActor.h"
 #include "Components/SphereComponent.h"
 #include "Components/DecalComponent.h"
+#include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "SPowerupActor.h"
+#include "SMemoryTags.h"
+#include "SEffectData.h"
+#include "SEffectStackComponent.h"
+#include "SNetStats.h"
+#include "UnrealNetwork.h"
 
 ASPickupActor::ASPickupActor()
 {
@@ -18,33 +24,76 @@ ASPickupActor::ASPickupActor()
 	DecalComp->DecalSize = FVector(64, 75, 75);
 	DecalComp->SetupAttachment(RootComponent);
 
+	MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComp->SetupAttachment(RootComponent);
+
 	CooldownDuration = 10.f;
+	bEffectAvailable = false;
 
 	SetReplicates(true);
+	// Only an Effect pickup has replicated state, and it flushes dormancy when that changes
+	NetDormancy = DORM_Initial;
 }
 
 void ASPickupActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (Effect) {
+		MeshComp->SetStaticMesh(Effect->PickupMesh);
+	}
+	MeshComp->SetVisibility(bEffectAvailable);
+
 	if (HasAuthority()) {
 		Respawn();
 	}
 }
 
 void ASPickupActor::Respawn() {
-	if (!ensure(PowerUpClass)) { return; }
 	if (!HasAuthority()) { return; }
 
+	if (Effect) {
+		SetEffectAvailable(true);
+		return;
+	}
+
+	if (!ensure(PowerUpClass)) { return; }
+
+	COOP_LLM_SCOPE(ESMemoryTag::Pickups);
+
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
 	PowerUpInstance = GetWorld()->SpawnActor<ASPowerupActor>(PowerUpClass, GetTransform(), SpawnParams);
 }
 
+void ASPickupActor::Reset() {
+	Super::Reset();
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_RespawnTimer);
+
+	if (HasAuthority() && !PowerUpInstance && !bEffectAvailable) {
+		Respawn();
+	}
+}
+
 void ASPickupActor::NotifyActorBeginOverlap(AActor* OtherActor) {
 	Super::NotifyActorBeginOverlap(OtherActor);
 
+	if (!HasAuthority()) { return; }
+
+	if (bEffectAvailable) {
+		auto EffectStack = OtherActor ? OtherActor->FindComponentByClass<USEffectStackComponent>() : nullptr;
+		if (!EffectStack) { return; }
+
+		EffectStack->ApplyEffect(Effect);
+		SetEffectAvailable(false);
+
+		GetWorldTimerManager().SetTimer(TimerHandle_RespawnTimer, this, &ASPickupActor::Respawn, CooldownDuration);
+		return;
+	}
+
 	// Grant a powerup to player if available
 	if (PowerUpInstance) {
 		PowerUpInstance->ActivatePowerup(OtherActor);
@@ -53,3 +102,27 @@ void ASPickupActor::NotifyActorBeginOverlap(AActor* OtherActor) {
 		GetWorldTimerManager().SetTimer(TimerHandle_RespawnTimer, this, &ASPickupActor::Respawn, CooldownDuration);
 	}
 }
+
+void ASPickupActor::SetEffectAvailable(bool bNewAvailable) {
+	if (bEffectAvailable == bNewAvailable) { return; }
+
+	bEffectAvailable = bNewAvailable;
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASPickupActor, bEffectAvailable));
+	FlushNetDormancy();
+
+	OnRep_EffectAvailable();
+}
+
+void ASPickupActor::OnRep_EffectAvailable() {
+	if (!HasAuthority()) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASPickupActor, bEffectAvailable));
+	}
+
+	MeshComp->SetVisibility(bEffectAvailable);
+}
+
+void ASPickupActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASPickupActor, bEffectAvailable);
+}
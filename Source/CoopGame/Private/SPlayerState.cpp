@@ -1,8 +1,23 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "SPlayerState.h"
+#include "AI/STrackerBot.h"
+#include "SNetStats.h"
+#include "SMatchLog.h"
 
 
 void ASPlayerState::AddScore(float ScoreDelta) {
 	Score += ScoreDelta;
+
+	FSMatchLog::Get().LogScore(this, ScoreDelta);
+}
+
+void ASPlayerState::ClientReceiveBotMovement_Implementation(float ServerTime, const TArray<FSBotMovementUpdate>& Updates) {
+	FSNetStats::Get().RecordRPCReceived(this, GET_FUNCTION_NAME_CHECKED(ASPlayerState, ClientReceiveBotMovement), 32 + Updates.Num() * FSBotMovementUpdate::ApproxBits);
+
+	for (const FSBotMovementUpdate& Update : Updates) {
+		if (Update.Bot) {
+			Update.Bot->ReceiveMovement(ServerTime, Update.Location, Update.Velocity);
+		}
+	}
 }
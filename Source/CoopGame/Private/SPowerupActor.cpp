@@ -1,6 +1,7 @@
 #include "SPowerupActor.h"
 #include "TimerManager.h"
 #include "UnrealNetwork.h"
+#include "SNetStats.h"
 
 ASPowerupActor::ASPowerupActor() {
 	PowerupInterval = 0.f;
@@ -8,12 +9,16 @@ ASPowerupActor::ASPowerupActor() {
 	bIsPowerupActive = false;
 
 	SetReplicates(true);
+	// Only bIsPowerupActive replicates, and only when it changes
+	NetDormancy = DORM_DormantAll;
 }
 
 void ASPowerupActor::ActivatePowerup(AActor* ActivateFor) {
 	OnActivated(ActivateFor);
 
 	bIsPowerupActive = true;
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASPowerupActor, bIsPowerupActive));
+	ForceNetUpdate();
 	OnRep_PowerupActive();
 
 	if (PowerupInterval > 0.f) {
@@ -29,16 +34,34 @@ void ASPowerupActor::OnTickPowerup() {
 	OnPowerupTicked();
 	
 	if (TicksProcessed >= TotalNrOfTicks) {
-		OnExpired();
+		Expire();
+	}
+}
+
+void ASPowerupActor::Expire() {
+	OnExpired();
+
+	bIsPowerupActive = false;
+	FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASPowerupActor, bIsPowerupActive));
+	ForceNetUpdate();
+	OnRep_PowerupActive();
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_PowerupTick);
+}
 
-		bIsPowerupActive = false;
-		OnRep_PowerupActive();
+void ASPowerupActor::Reset() {
+	Super::Reset();
 
-		GetWorldTimerManager().ClearTimer(TimerHandle_PowerupTick);
+	if (HasAuthority() && bIsPowerupActive) {
+		Expire();
 	}
 }
 
 void ASPowerupActor::OnRep_PowerupActive() {
+	if (!HasAuthority()) {
+		FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASPowerupActor, bIsPowerupActive));
+	}
+
 	OnPowerupStateChange(bIsPowerupActive);
 }
 
@@ -0,0 +1,304 @@
+#include "SProjectileManager.h"
+#include "SWeapon.h"
+#include "SWorldManager.h"
+#include "SSurfaceSettings.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "SEffectStackComponent.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Kismet/GameplayStatics.h"
+#include "DrawDebugHelpers.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Step Projectiles"), STAT_StepProjectiles, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_CoopGame);
+
+static int32 DebugProjectileDrawing = 0;
+FAutoConsoleVariableRef CVARDebugProjectileDrawing(
+	TEXT("COOP.DebugProjectiles"),
+	DebugProjectileDrawing,
+	TEXT("Draw debug spheres for projectiles"),
+	ECVF_Cheat);
+
+static int32 ProjectileParallelThreshold = 16;
+FAutoConsoleVariableRef CVARProjectileParallelThreshold(
+	TEXT("COOP.ProjectileParallelThreshold"),
+	ProjectileParallelThreshold,
+	TEXT("Minimum number of projectiles in flight before their sweeps are spread across worker threads"),
+	ECVF_Default);
+
+FSProjectileParams::FSProjectileParams() {
+	Speed = 2000.f;
+	GravityScale = 1.f;
+	LifeSpan = 1.f;
+	CollisionRadius = 5.f;
+	bExplodeOnImpact = false;
+	Bounciness = 0.3f;
+	Damage = 100.f;
+	DamageRadius = 200.f;
+	VisualMesh = nullptr;
+	ExplosionEffect = nullptr;
+	ExplosionSound = nullptr;
+}
+
+ASProjectileManager::ASProjectileManager() {
+	PrimaryActorTick.bCanEverTick = true;
+
+	SetReplicates(true);
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 1.f;
+
+	NextProjectileId = 0;
+}
+
+ASProjectileManager* ASProjectileManager::Get(UWorld* World) {
+	const bool bCanSpawn = World && World->GetNetMode() != NM_Client;
+	return GetWorldManager<ASProjectileManager>(World, bCanSpawn);
+}
+
+const FSProjectileParams* ASProjectileManager::GetProjectileParams(UClass* WeaponClass) {
+	auto WeaponCDO = WeaponClass ? Cast<ASWeapon>(WeaponClass->GetDefaultObject()) : nullptr;
+	return WeaponCDO ? WeaponCDO->GetProjectileParams() : nullptr;
+}
+
+void ASProjectileManager::SpawnProjectile(ASWeapon* Weapon, const FVector& Origin, const FVector& Direction) {
+	if (!HasAuthority() || !Weapon) { return; }
+
+	COOP_LLM_SCOPE(ESMemoryTag::Projectiles);
+
+	auto Params = GetProjectileParams(Weapon->GetClass());
+	if (!Params) { return; }
+
+	auto WeaponOwner = Weapon->GetOwner();
+	const FVector Velocity = Direction.GetSafeNormal() * Params->Speed;
+	const uint16 ProjectileId = NextProjectileId++;
+
+	AddProjectile(ProjectileId, Weapon->GetClass(), WeaponOwner, WeaponOwner ? WeaponOwner->GetInstigatorController() : nullptr, Origin, Velocity);
+
+	FSProjectileSpawnEvent Event;
+	Event.ProjectileId = ProjectileId;
+	Event.WeaponClass = Weapon->GetClass();
+	Event.Instigator = WeaponOwner;
+	Event.Origin = Origin;
+	Event.Velocity = Velocity;
+	PendingSpawnEvents.Add(Event);
+}
+
+void ASProjectileManager::AddProjectile(uint16 ProjectileId, UClass* WeaponClass, AActor* Instigator, AController* InstigatorController, const FVector& Origin, const FVector& Velocity) {
+	auto Params = GetProjectileParams(WeaponClass);
+	if (!Params) { return; }
+
+	FSProjectile Projectile;
+	Projectile.Position = Origin;
+	Projectile.Velocity = Velocity;
+	Projectile.LifeRemaining = Params->LifeSpan;
+	Projectile.ProjectileId = ProjectileId;
+	Projectile.Params = Params;
+	Projectile.WeaponClass = WeaponClass;
+	Projectile.Instigator = Instigator;
+	Projectile.InstigatorController = InstigatorController;
+	Projectile.Visual = AcquireVisual(Params->VisualMesh);
+
+	if (Projectile.Visual) {
+		Projectile.Visual->SetWorldLocationAndRotation(Origin, Velocity.Rotation());
+	}
+
+	Projectiles.Add(Projectile);
+}
+
+void ASProjectileManager::RemoveProjectileAt(int32 Index) {
+	ReleaseVisual(Projectiles[Index].Visual);
+	Projectiles.RemoveAtSwap(Index, 1, false);
+}
+
+void ASProjectileManager::Reset() {
+	Super::Reset();
+
+	for (int32 Index = Projectiles.Num() - 1; Index >= 0; --Index) {
+		RemoveProjectileAt(Index);
+	}
+
+	PendingSpawnEvents.Reset();
+	PendingExplodeEvents.Reset();
+}
+
+void ASProjectileManager::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	COOP_LLM_SCOPE(ESMemoryTag::Projectiles);
+
+	const int32 NrOfProjectiles = Projectiles.Num();
+	SET_DWORD_STAT(STAT_ProjectilesInFlight, NrOfProjectiles);
+
+	if (NrOfProjectiles > 0) {
+		SCOPE_CYCLE_COUNTER(STAT_StepProjectiles);
+
+		UWorld* World = GetWorld();
+		const float GravityZ = World->GetGravityZ();
+
+		StepHits.SetNum(NrOfProjectiles, false);
+		StepBlockingHits.SetNum(NrOfProjectiles, false);
+
+		// Integrate and sweep every projectile, spreading large batches across worker threads
+		ParallelFor(NrOfProjectiles, [this, World, GravityZ, DeltaSeconds](int32 Index) {
+			FSProjectile& Projectile = Projectiles[Index];
+
+			const FVector NewVelocity = Projectile.Velocity + FVector(0.f, 0.f, GravityZ * Projectile.Params->GravityScale * DeltaSeconds);
+			const FVector NewPosition = Projectile.Position + (Projectile.Velocity + NewVelocity) * 0.5f * DeltaSeconds;
+
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileSweep), false, Projectile.Instigator.Get());
+			QueryParams.bReturnPhysicalMaterial = true;
+
+			StepBlockingHits[Index] = World->SweepSingleByChannel(StepHits[Index], Projectile.Position, NewPosition, FQuat::Identity,
+				COLLISION_WEAPON, FCollisionShape::MakeSphere(Projectile.Params->CollisionRadius), QueryParams);
+
+			if (StepBlockingHits[Index]) {
+				const FHitResult& Hit = StepHits[Index];
+				Projectile.Position = Hit.Location;
+				Projectile.Velocity = NewVelocity.MirrorByVector(Hit.ImpactNormal) * Projectile.Params->Bounciness;
+			} else {
+				Projectile.Position = NewPosition;
+				Projectile.Velocity = NewVelocity;
+			}
+
+			Projectile.LifeRemaining -= DeltaSeconds;
+		}, NrOfProjectiles < ProjectileParallelThreshold);
+
+		// Resolve explosions and visuals on the game thread, iterating backwards so finished projectiles can be swapped out
+		for (int32 Index = NrOfProjectiles - 1; Index >= 0; --Index) {
+			const FSProjectile& Projectile = Projectiles[Index];
+
+			const bool bImpactExplosion = StepBlockingHits[Index] && Projectile.Params->bExplodeOnImpact;
+			if (bImpactExplosion || Projectile.LifeRemaining <= 0.f) {
+				// Clients only hide their copy, the server's explode event plays the effects
+				if (HasAuthority()) {
+					const EPhysicalSurface SurfaceType = StepBlockingHits[Index] ? UPhysicalMaterial::DetermineSurfaceType(StepHits[Index].PhysMaterial.Get()) : SurfaceType_Max;
+					Explode(Projectile, Projectile.Position, SurfaceType);
+				}
+
+				RemoveProjectileAt(Index);
+				continue;
+			}
+
+			if (Projectile.Visual) {
+				Projectile.Visual->SetWorldLocationAndRotation(Projectile.Position, Projectile.Velocity.Rotation());
+			}
+
+			if (DebugProjectileDrawing) {
+				DrawDebugSphere(World, Projectile.Position, Projectile.Params->CollisionRadius, 8, HasAuthority() ? FColor::Red : FColor::Green, false, 0.f);
+			}
+		}
+	}
+
+	if (PendingSpawnEvents.Num() > 0) {
+		MulticastSpawnProjectiles(PendingSpawnEvents);
+		PendingSpawnEvents.Reset();
+	}
+
+	if (PendingExplodeEvents.Num() > 0) {
+		MulticastExplodeProjectiles(PendingExplodeEvents);
+		PendingExplodeEvents.Reset();
+	}
+}
+
+void ASProjectileManager::Explode(const FSProjectile& Projectile, const FVector& Location, EPhysicalSurface SurfaceType) {
+	const FSProjectileParams& Params = *Projectile.Params;
+
+	TArray<AActor*> IgnoredActors;
+	const float Damage = Params.Damage * USEffectStackComponent::GetDamageMultiplier(Projectile.Instigator.Get());
+
+	UGameplayStatics::ApplyRadialDamage(this, Damage, Location, Params.DamageRadius, Params.DamageType, IgnoredActors,
+		Projectile.Instigator.Get(), Projectile.InstigatorController.Get());
+
+	if (DebugProjectileDrawing) {
+		DrawDebugSphere(GetWorld(), Location, Params.DamageRadius, 12, FColor::Red, false, 2.f, 0, 1.f);
+	}
+
+	PlayExplosionEffects(Params, Location, SurfaceType);
+
+	FSProjectileExplodeEvent Event;
+	Event.ProjectileId = Projectile.ProjectileId;
+	Event.WeaponClass = Projectile.WeaponClass;
+	Event.Location = Location;
+	Event.SurfaceType = SurfaceType;
+	PendingExplodeEvents.Add(Event);
+}
+
+void ASProjectileManager::PlayExplosionEffects(const FSProjectileParams& Params, const FVector& Location, EPhysicalSurface SurfaceType) {
+	if (GetNetMode() == NM_DedicatedServer) { return; }
+
+	COOP_LLM_SCOPE(ESMemoryTag::Effects);
+
+	if (Params.ExplosionEffect) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Params.ExplosionEffect, Location);
+	}
+
+	if (Params.ExplosionSound) {
+		UGameplayStatics::PlaySoundAtLocation(this, Params.ExplosionSound, Location);
+	}
+
+	// Surface sound and decal of whatever the projectile landed on, projected downwards
+	if (SurfaceType < SurfaceType_Max) {
+		USSurfaceSettings::GetTable().PlayImpact(this, SurfaceType, Location, FVector::DownVector.Rotation(), nullptr);
+	}
+}
+
+void ASProjectileManager::MulticastSpawnProjectiles_Implementation(const TArray<FSProjectileSpawnEvent>& Events) {
+	// The server already simulates its own copy
+	if (HasAuthority()) { return; }
+
+	for (const FSProjectileSpawnEvent& Event : Events) {
+		AddProjectile(Event.ProjectileId, Event.WeaponClass, Event.Instigator, nullptr, Event.Origin, Event.Velocity);
+	}
+}
+
+void ASProjectileManager::MulticastExplodeProjectiles_Implementation(const TArray<FSProjectileExplodeEvent>& Events) {
+	if (HasAuthority()) { return; }
+
+	for (const FSProjectileExplodeEvent& Event : Events) {
+		for (int32 Index = 0; Index < Projectiles.Num(); ++Index) {
+			if (Projectiles[Index].ProjectileId == Event.ProjectileId) {
+				RemoveProjectileAt(Index);
+				break;
+			}
+		}
+
+		auto Params = GetProjectileParams(Event.WeaponClass);
+		if (Params) {
+			PlayExplosionEffects(*Params, Event.Location, Event.SurfaceType);
+		}
+	}
+}
+
+UStaticMeshComponent* ASProjectileManager::AcquireVisual(UStaticMesh* Mesh) {
+	if (!Mesh || GetNetMode() == NM_DedicatedServer) { return nullptr; }
+
+	UStaticMeshComponent* Visual = nullptr;
+
+	if (FreeVisuals.Num() > 0) {
+		Visual = FreeVisuals.Pop(false);
+	} else {
+		Visual = NewObject<UStaticMeshComponent>(this);
+		Visual->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Visual->SetCanEverAffectNavigation(false);
+		Visual->SetMobility(EComponentMobility::Movable);
+		Visual->RegisterComponent();
+
+		VisualPool.Add(Visual);
+	}
+
+	Visual->SetStaticMesh(Mesh);
+	Visual->SetVisibility(true);
+
+	return Visual;
+}
+
+void ASProjectileManager::ReleaseVisual(UStaticMeshComponent* Visual) {
+	if (!Visual) { return; }
+
+	Visual->SetVisibility(false);
+	FreeVisuals.Add(Visual);
+}
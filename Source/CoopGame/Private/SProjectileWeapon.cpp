@@ -1,28 +1,69 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "SProjectileWeapon.h"
-#include "SWeapon.h"
-#include "DrawDebugHelpers.h"
-#include "Engine/World.h"
-#include "Kismet/GameplayStatics.h"
-#include "Components/SkeletalMeshComponent.h"
-#include "Particles/ParticleSystemComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Engine/SCS_Node.h"
+#include "Particles/ParticleSystem.h"
 
+// What BP_GrenadeProjectile's graph spawned when it exploded, it isn't a property that can be read back
+static const TCHAR* LegacyExplosionEffectPath = TEXT("/Game/Weapons/WeaponEffects/Explosion/P_Explosion.P_Explosion");
 
-void ASProjectileWeapon::Fire() {
-	auto WeaponOwner = GetOwner();
+// Blueprint components live in the construction script rather than on the class default object
+template<class T>
+static T* FindComponentTemplate(UClass* ActorClass) {
+	for (UClass* Class = ActorClass; Class; Class = Class->GetSuperClass()) {
+		auto BPClass = Cast<UBlueprintGeneratedClass>(Class);
+		if (!BPClass || !BPClass->SimpleConstructionScript) { continue; }
 
-	if (WeaponOwner && ProjectileClass) {
-		FVector EyeLocation;
-		FRotator EyeRotation;
-		WeaponOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+		for (USCS_Node* Node : BPClass->SimpleConstructionScript->GetAllNodes()) {
+			if (auto Template = Cast<T>(Node->ComponentTemplate)) {
+				return Template;
+			}
+		}
+	}
+
+	auto ActorCDO = ActorClass->GetDefaultObject<AActor>();
+	return ActorCDO ? ActorCDO->FindComponentByClass<T>() : nullptr;
+}
 
-		auto MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
+ASProjectileWeapon::ASProjectileWeapon() {
+	DefaultFireMode = ESWeaponFireMode::Projectile;
+	bMigratedProjectileClass = false;
+}
+
+void ASProjectileWeapon::BeginPlay() {
+	// The projectile manager reads the params of the class default object
+	GetClass()->GetDefaultObject<ASProjectileWeapon>()->MigrateProjectileClass();
+
+	Super::BeginPlay();
+}
 
-		FActorSpawnParameters SpawnParams;
+void ASProjectileWeapon::MigrateProjectileClass() {
+	if (bMigratedProjectileClass) { return; }
+	bMigratedProjectileClass = true;
 
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// Params set up by hand win
+	if (!ProjectileClass || ProjectileParams.VisualMesh) { return; }
 
-		GetWorld()->SpawnActor<AActor>(ProjectileClass, MuzzleLocation, EyeRotation, SpawnParams);
+	if (auto Movement = FindComponentTemplate<UProjectileMovementComponent>(ProjectileClass)) {
+		ProjectileParams.Speed = Movement->InitialSpeed;
+		ProjectileParams.GravityScale = Movement->ProjectileGravityScale;
+		ProjectileParams.bExplodeOnImpact = !Movement->bShouldBounce;
+		ProjectileParams.Bounciness = Movement->Bounciness;
 	}
+
+	if (auto Mesh = FindComponentTemplate<UStaticMeshComponent>(ProjectileClass)) {
+		ProjectileParams.VisualMesh = Mesh->GetStaticMesh();
+	}
+
+	if (!ProjectileParams.ExplosionEffect) {
+		ProjectileParams.ExplosionEffect = LoadObject<UParticleSystem>(nullptr, LegacyExplosionEffectPath);
+	}
+}
+
+const FSProjectileParams* ASProjectileWeapon::GetProjectileParams() const {
+	return WeaponData ? Super::GetProjectileParams() : &ProjectileParams;
 }
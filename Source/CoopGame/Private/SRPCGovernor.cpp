@@ -0,0 +1,102 @@
+#include "SRPCGovernor.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Actor.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rejected Server RPCs"), STAT_RejectedServerRPCs, STATGROUP_CoopGame);
+
+static float ServerRPCBudget = 30.f;
+FAutoConsoleVariableRef CVARServerRPCBudget(
+	TEXT("COOP.ServerRPCBudget"),
+	ServerRPCBudget,
+	TEXT("Server RPCs a client connection may call per second, with up to a second's worth in a burst. 0 disables the budget"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithOutputDevice DumpRPCRejectionsCommand(
+	TEXT("COOP.DumpRPCRejections"),
+	TEXT("Log how many server RPCs every client connection had dropped, by function"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar) {
+		FSRPCGovernor::Get().Dump(Ar);
+	}));
+
+FSRPCGovernor& FSRPCGovernor::Get() {
+	static FSRPCGovernor Instance;
+	return Instance;
+}
+
+FSRPCGovernor::FConnectionBudget* FSRPCGovernor::FindBudget(const AActor* Actor) {
+	auto Connection = Actor ? Actor->GetNetConnection() : nullptr;
+	if (!Connection) { return nullptr; }
+
+	FConnectionBudget* Budget = Connections.Find(Connection);
+	if (!Budget) {
+		// Closed connections are only forgotten when a new one shows up
+		for (auto It = Connections.CreateIterator(); It; ++It) {
+			if (!It.Key().IsValid()) {
+				It.RemoveCurrent();
+			}
+		}
+
+		Budget = &Connections.Add(Connection);
+		auto World = Connection->Driver ? Connection->Driver->GetWorld() : nullptr;
+		Budget->Name = FString::Printf(TEXT("%s %s"), World ? *World->GetName() : TEXT("?"), *Connection->LowLevelGetRemoteAddress(true));
+		Budget->Tokens = ServerRPCBudget;
+		Budget->LastRefillTime = FPlatformTime::Seconds();
+	}
+
+	return Budget;
+}
+
+bool FSRPCGovernor::ConsumeServerRPC(const AActor* Actor, FName FunctionName, float MinCallsPerSecond) {
+	if (ServerRPCBudget <= 0.f) { return true; }
+
+	FConnectionBudget* Budget = FindBudget(Actor);
+
+	// Calls from the listen server's own player don't cross the network
+	if (!Budget) { return true; }
+
+	const float CallsPerSecond = FMath::Max(ServerRPCBudget, MinCallsPerSecond);
+	const double Now = FPlatformTime::Seconds();
+	Budget->Tokens = FMath::Min(Budget->Tokens + float(Now - Budget->LastRefillTime) * CallsPerSecond, CallsPerSecond);
+	Budget->LastRefillTime = Now;
+
+	if (Budget->Tokens < 1.f) {
+		RecordRejected(Actor, FunctionName, TEXT("over connection budget"));
+		return false;
+	}
+
+	Budget->Tokens -= 1.f;
+	return true;
+}
+
+void FSRPCGovernor::RecordRejected(const AActor* Actor, FName FunctionName, const TCHAR* Reason) {
+	INC_DWORD_STAT(STAT_RejectedServerRPCs);
+
+	FConnectionBudget* Budget = FindBudget(Actor);
+	if (!Budget) { return; }
+
+	Budget->TotalRejected++;
+	Budget->Rejected.FindOrAdd(FunctionName)++;
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - Budget->LastWarningTime >= 1.0) {
+		Budget->LastWarningTime = Now;
+		UE_LOG(LogCoopGame, Warning, TEXT("Dropped %s from %s: %s (%d dropped so far)"),
+			*FunctionName.ToString(), *Budget->Name, Reason, Budget->TotalRejected);
+	}
+}
+
+void FSRPCGovernor::Dump(FOutputDevice& Ar) const {
+	Ar.Logf(TEXT("Dropped server RPCs for %d connection(s)"), Connections.Num());
+
+	for (const auto& Pair : Connections) {
+		const FConnectionBudget& Budget = Pair.Value;
+		Ar.Logf(TEXT("%s: %d dropped"), *Budget.Name, Budget.TotalRejected);
+
+		for (const auto& Rejected : Budget.Rejected) {
+			Ar.Logf(TEXT("  %-28s %d"), *Rejected.Key.ToString(), Rejected.Value);
+		}
+	}
+}
@@ -0,0 +1,243 @@
+#include "SSpikeCatcher.h"
+#include "SWorldManager.h"
+#include "SGameMode.h"
+#include "SGameState.h"
+#include "SBotDecisions.h"
+#include "CoopGame.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "TimerManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Async/Async.h"
+
+static int32 SpikeCatcherMode = 1;
+FAutoConsoleVariableRef CVARSpikeCatcherMode(
+	TEXT("COOP.SpikeCatcher"),
+	SpikeCatcherMode,
+	TEXT("Record a profile when a server frame hitches. 0 off, 1 dedicated servers, 2 listen servers too. Read when the match starts"),
+	ECVF_Default);
+
+static float SpikeThresholdMs = 100.f;
+FAutoConsoleVariableRef CVARSpikeThresholdMs(
+	TEXT("COOP.SpikeThresholdMs"),
+	SpikeThresholdMs,
+	TEXT("Frames longer than this, in milliseconds, are dumped by the spike catcher"),
+	ECVF_Default);
+
+static int32 SpikeHistoryFrames = 300;
+FAutoConsoleVariableRef CVARSpikeHistoryFrames(
+	TEXT("COOP.SpikeHistoryFrames"),
+	SpikeHistoryFrames,
+	TEXT("Frames of counters kept by the spike catcher and written out with a spike"),
+	ECVF_Default);
+
+static float SpikeCaptureSeconds = 2.f;
+FAutoConsoleVariableRef CVARSpikeCaptureSeconds(
+	TEXT("COOP.SpikeCaptureSeconds"),
+	SpikeCaptureSeconds,
+	TEXT("Length of the stats capture started after a spike. 0 only writes the counters"),
+	ECVF_Default);
+
+static float SpikeCooldown = 30.f;
+FAutoConsoleVariableRef CVARSpikeCooldown(
+	TEXT("COOP.SpikeCooldown"),
+	SpikeCooldown,
+	TEXT("Seconds after a dump before the spike catcher dumps again, so a bad patch doesn't fill the disk"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpSpikeCommand(
+	TEXT("COOP.DumpSpike"),
+	TEXT("Server only: write the spike catcher's recent frames to Saved/Profiling now, as if the last frame had hitched"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		auto SpikeCatcher = ASSpikeCatcher::Get(World);
+		if (!SpikeCatcher) {
+			Ar.Log(TEXT("COOP.DumpSpike needs a server with COOP.SpikeCatcher enabled"));
+			return;
+		}
+
+		SpikeCatcher->DumpSpike(TEXT("COOP.DumpSpike"));
+	}));
+
+TMap<const UWorld*, FSFrameCounters>& FSFrameCounters::GetWorldCounters() {
+	static TMap<const UWorld*, FSFrameCounters> WorldCounters;
+	return WorldCounters;
+}
+
+FSFrameCounters& FSFrameCounters::Get(const UObject* WorldContext) {
+	static FSFrameCounters Scratch;
+
+	FSFrameCounters* Counters = WorldContext ? GetWorldCounters().Find(WorldContext->GetWorld()) : nullptr;
+	if (!Counters) {
+		Scratch = FSFrameCounters();
+		return Scratch;
+	}
+
+	return *Counters;
+}
+
+ASSpikeCatcher::ASSpikeCatcher() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Last in the frame, so a sample covers everything the frame did
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	SetReplicates(false);
+
+	NextSample = 0;
+	LastFrameTime = 0.0;
+	LastDumpTime = -BIG_NUMBER;
+	LastNetBytesIn = 0;
+	LastNetBytesOut = 0;
+	bCapturing = false;
+}
+
+ASSpikeCatcher* ASSpikeCatcher::Get(UWorld* World) {
+	if (!World || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone) { return nullptr; }
+	if (SpikeCatcherMode <= 0 || (SpikeCatcherMode == 1 && World->GetNetMode() != NM_DedicatedServer)) { return nullptr; }
+
+	return GetWorldManager<ASSpikeCatcher>(World);
+}
+
+void ASSpikeCatcher::BeginPlay() {
+	Super::BeginPlay();
+
+	// Only worlds with a spike catcher keep counters
+	FSFrameCounters::GetWorldCounters().Add(GetWorld());
+}
+
+void ASSpikeCatcher::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	StopCapture();
+	FSFrameCounters::GetWorldCounters().Remove(GetWorld());
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASSpikeCatcher::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	// Wall clock rather than DeltaSeconds, which is clamped and dilated
+	const double Now = FPlatformTime::Seconds();
+	const float FrameMs = LastFrameTime > 0.0 ? float((Now - LastFrameTime) * 1000.0) : 0.f;
+	LastFrameTime = Now;
+
+	Sample(FrameMs);
+
+	if (FrameMs > SpikeThresholdMs && Now - LastDumpTime >= SpikeCooldown) {
+		DumpSpike(FString::Printf(TEXT("Frame took %.1f ms"), FrameMs));
+	}
+}
+
+void ASSpikeCatcher::Sample(float FrameMs) {
+	FSFrameCounters& Counters = FSFrameCounters::Get(this);
+
+	FSFrameSample FrameSample;
+	FrameSample.Time = GetWorld()->TimeSeconds;
+	FrameSample.FrameMs = FrameMs;
+	FrameSample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+	auto Decisions = ASBotDecisions::Get(GetWorld());
+	FrameSample.BotsAlive = Decisions ? Decisions->GetNrOfActiveBots() : 0;
+
+	FrameSample.PathsRequested = Counters.PathsRequested;
+	FrameSample.WeaponTraces = Counters.WeaponTraces;
+	FrameSample.DamageEvents = Counters.DamageEvents;
+	Counters = FSFrameCounters();
+
+	// The driver's byte counts restart every stat period
+	auto NetDriver = GetWorld()->GetNetDriver();
+	const uint32 NetBytesIn = NetDriver ? NetDriver->InBytes : 0;
+	const uint32 NetBytesOut = NetDriver ? NetDriver->OutBytes : 0;
+	FrameSample.NetBytesIn = NetBytesIn >= LastNetBytesIn ? NetBytesIn - LastNetBytesIn : NetBytesIn;
+	FrameSample.NetBytesOut = NetBytesOut >= LastNetBytesOut ? NetBytesOut - LastNetBytesOut : NetBytesOut;
+	LastNetBytesIn = NetBytesIn;
+	LastNetBytesOut = NetBytesOut;
+
+	const int32 Capacity = FMath::Max(SpikeHistoryFrames, 1);
+	if (Samples.Num() > Capacity) {
+		Samples.Reset();
+		NextSample = 0;
+	}
+
+	if (Samples.Num() < Capacity) {
+		Samples.Add(FrameSample);
+	} else {
+		Samples[NextSample] = FrameSample;
+		NextSample = (NextSample + 1) % Capacity;
+	}
+}
+
+void ASSpikeCatcher::DumpSpike(const FString& Reason) {
+	LastDumpTime = FPlatformTime::Seconds();
+
+	FString WaveState = TEXT("?");
+	int32 WaveCount = 0;
+
+	if (auto GM = GetWorld()->GetAuthGameMode<ASGameMode>()) {
+		WaveCount = GM->GetWaveCount();
+
+		auto GS = GM->GetGameState<ASGameState>();
+		auto WaveStateEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EWaveState"));
+		if (GS && WaveStateEnum) {
+			WaveState = WaveStateEnum->GetNameStringByValue((int64)GS->GetWaveState());
+		}
+	}
+
+	const FString Name = FString::Printf(TEXT("Spike-%s-%s"), *GetWorld()->GetName(), *FDateTime::Now().ToString());
+	const FString FileName = FPaths::ProjectSavedDir() / TEXT("Profiling") / Name + TEXT(".csv");
+	const FString Header = FString::Printf(TEXT("# %s\n# Map %s, wave %d (%s)\n"), *Reason, *GetWorld()->GetMapName(), WaveCount, *WaveState);
+
+	// Oldest first. Formatting and writing happen off the game thread, the frame has already hitched
+	TArray<FSFrameSample> Snapshot;
+	Snapshot.Reserve(Samples.Num());
+	for (int32 Offset = 0; Offset < Samples.Num(); ++Offset) {
+		Snapshot.Add(Samples[(NextSample + Offset) % Samples.Num()]);
+	}
+
+	UE_LOG(LogCoopGame, Warning, TEXT("%s during wave %d (%s), writing %d frames to %s"), *Reason, WaveCount, *WaveState, Snapshot.Num(), *FileName);
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [FileName, Header, Snapshot]() {
+		FString Text = Header;
+		Text += TEXT("Time,FrameMs,GameThreadMs,BotsAlive,PathsRequested,WeaponTraces,DamageEvents,NetBytesIn,NetBytesOut\n");
+
+		for (const FSFrameSample& FrameSample : Snapshot) {
+			Text += FString::Printf(TEXT("%.3f,%.2f,%.2f,%d,%d,%d,%d,%d,%d\n"), FrameSample.Time, FrameSample.FrameMs, FrameSample.GameThreadMs,
+				FrameSample.BotsAlive, FrameSample.PathsRequested, FrameSample.WeaponTraces, FrameSample.DamageEvents, FrameSample.NetBytesIn, FrameSample.NetBytesOut);
+		}
+
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FileName));
+		if (!Writer) {
+			UE_LOG(LogCoopGame, Warning, TEXT("Spike catcher couldn't write %s"), *FileName);
+			return;
+		}
+
+		FTCHARToUTF8 UTF8(*Text);
+		Writer->Serialize((void*)UTF8.Get(), UTF8.Length());
+		Writer->Close();
+	});
+
+	StartCapture(Name);
+}
+
+void ASSpikeCatcher::StartCapture(const FString& Name) {
+#if STATS
+	if (bCapturing || SpikeCaptureSeconds <= 0.f || !GEngine) { return; }
+
+	// Can only start after the spike, the counters above cover the frames before it
+	bCapturing = true;
+	GEngine->Exec(GetWorld(), *FString::Printf(TEXT("stat startfile %s.ue4stats"), *Name));
+	GetWorldTimerManager().SetTimer(TimerHandle_StopCapture, this, &ASSpikeCatcher::StopCapture, SpikeCaptureSeconds, false);
+#endif
+}
+
+void ASSpikeCatcher::StopCapture() {
+	if (!bCapturing) { return; }
+
+	bCapturing = false;
+	GetWorldTimerManager().ClearTimer(TimerHandle_StopCapture);
+
+	if (GEngine) {
+		GEngine->Exec(GetWorld(), TEXT("stat stopfile"));
+	}
+}
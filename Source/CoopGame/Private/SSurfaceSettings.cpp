@@ -0,0 +1,98 @@
+#include "SSurfaceSettings.h"
+#include "CoopGame.h"
+#include "SMemoryTags.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+#include "Materials/MaterialInterface.h"
+
+
+FSSurfaceSettingsEntry::FSSurfaceSettingsEntry() {
+	SurfaceType = SurfaceType_Default;
+	DamageMultiplier = 1.f;
+	DecalSize = FVector(8.f, 8.f, 8.f);
+	DecalLifeSpan = 10.f;
+}
+
+USSurfaceSettings::USSurfaceSettings() {
+	FSSurfaceSettingsEntry Vulnerable;
+	Vulnerable.SurfaceType = SURFACE_FLESHVULNERABLE;
+	Vulnerable.DamageMultiplier = 4.f;
+	Surfaces.Add(Vulnerable);
+
+	bTableBuilt = false;
+}
+
+FName USSurfaceSettings::GetCategoryName() const {
+	return TEXT("Game");
+}
+
+const FSSurfaceTable& USSurfaceSettings::GetTable() {
+	auto Settings = GetMutableDefault<USSurfaceSettings>();
+	if (!Settings->bTableBuilt) {
+		Settings->BuildTable();
+	}
+
+	return Settings->Table;
+}
+
+void USSurfaceSettings::BuildTable() {
+	TableAssets.Reset();
+
+	// Dedicated servers only need the damage multipliers
+	const bool bLoadCosmetics = !IsRunningDedicatedServer();
+
+	auto Fill = [this, bLoadCosmetics](int32 Index, const FSSurfaceSettingsEntry& Entry) {
+		Table.DamageMultipliers[Index] = Entry.DamageMultiplier;
+		Table.ImpactEffects[Index] = bLoadCosmetics ? Entry.ImpactEffect.LoadSynchronous() : nullptr;
+		Table.ImpactSounds[Index] = bLoadCosmetics ? Entry.ImpactSound.LoadSynchronous() : nullptr;
+		Table.ImpactDecals[Index] = bLoadCosmetics ? Entry.ImpactDecal.LoadSynchronous() : nullptr;
+		Table.DecalSizes[Index] = Entry.DecalSize;
+		Table.DecalLifeSpans[Index] = Entry.DecalLifeSpan;
+	};
+
+	for (int32 Index = 0; Index < SurfaceType_Max; ++Index) {
+		Fill(Index, DefaultSurface);
+	}
+
+	for (const FSSurfaceSettingsEntry& Entry : Surfaces) {
+		Fill(Entry.SurfaceType, Entry);
+	}
+
+	for (int32 Index = 0; Index < SurfaceType_Max; ++Index) {
+		TableAssets.AddUnique(Table.ImpactEffects[Index]);
+		TableAssets.AddUnique(Table.ImpactSounds[Index]);
+		TableAssets.AddUnique(Table.ImpactDecals[Index]);
+	}
+	TableAssets.Remove(nullptr);
+
+	bTableBuilt = true;
+}
+
+#if WITH_EDITOR
+void USSurfaceSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	bTableBuilt = false;
+}
+#endif
+
+void FSSurfaceTable::PlayImpact(UObject* WorldContextObject, EPhysicalSurface SurfaceType, const FVector& Location, const FRotator& Rotation, UParticleSystem* EffectOverride) const {
+	auto World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World || World->GetNetMode() == NM_DedicatedServer) { return; }
+
+	COOP_LLM_SCOPE(ESMemoryTag::Effects);
+	UParticleSystem* Effect = EffectOverride ? EffectOverride : ImpactEffects[SurfaceType];
+	if (Effect) {
+		UGameplayStatics::SpawnEmitterAtLocation(World, Effect, Location, Rotation);
+	}
+
+	if (ImpactSounds[SurfaceType]) {
+		UGameplayStatics::PlaySoundAtLocation(WorldContextObject, ImpactSounds[SurfaceType], Location);
+	}
+
+	if (ImpactDecals[SurfaceType]) {
+		UGameplayStatics::SpawnDecalAtLocation(WorldContextObject, ImpactDecals[SurfaceType], DecalSizes[SurfaceType], Location, Rotation, DecalLifeSpans[SurfaceType]);
+	}
+}
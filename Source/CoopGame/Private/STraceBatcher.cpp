@@ -0,0 +1,140 @@
+#include "STraceBatcher.h"
+#include "SWeapon.h"
+#include "SHitboxRegistry.h"
+#include "SSpikeCatcher.h"
+#include "SWorldManager.h"
+#include "CoopGame.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flush Weapon Traces"), STAT_FlushWeaponTraces, STATGROUP_CoopGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Traces"), STAT_WeaponTraces, STATGROUP_CoopGame);
+
+static int32 TraceBatchParallelThreshold = 8;
+FAutoConsoleVariableRef CVARTraceBatchParallelThreshold(
+	TEXT("COOP.TraceBatchParallelThreshold"),
+	TraceBatchParallelThreshold,
+	TEXT("Minimum number of weapon traces in a frame before they are resolved across worker threads"),
+	ECVF_Default);
+
+static int32 HitboxTraces = 1;
+FAutoConsoleVariableRef CVARHitboxTraces(
+	TEXT("COOP.HitboxTraces"),
+	HitboxTraces,
+	TEXT("Test weapon traces against the pawns' hitboxes before tracing the world. 0 traces pawn collision like any other"),
+	ECVF_Default);
+
+ASTraceBatcher::ASTraceBatcher() {
+	PrimaryActorTick.bCanEverTick = true;
+	// Run after timers so shots fired this frame are resolved this frame
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	SetReplicates(false);
+
+	Hitboxes = nullptr;
+}
+
+ASTraceBatcher* ASTraceBatcher::Get(UWorld* World) {
+	return GetWorldManager<ASTraceBatcher>(World);
+}
+
+void ASTraceBatcher::QueueTrace(const FSWeaponTrace& Trace) {
+	PendingTraces.Add(Trace);
+}
+
+void ASTraceBatcher::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	FlushTraces();
+}
+
+void ASTraceBatcher::FlushTraces() {
+	const int32 NrOfTraces = PendingTraces.Num();
+	if (NrOfTraces == 0) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_FlushWeaponTraces);
+	INC_DWORD_STAT_BY(STAT_WeaponTraces, NrOfTraces);
+	FSFrameCounters::Get(this).WeaponTraces += NrOfTraces;
+
+	Results.SetNum(NrOfTraces, false);
+	BlockingHits.SetNum(NrOfTraces, false);
+	SurfaceTypes.SetNum(NrOfTraces, false);
+
+	// Workers only read the hitboxes, so move them before any of them start
+	if (!Hitboxes) {
+		Hitboxes = ASHitboxRegistry::Get(GetWorld());
+	}
+	if (Hitboxes) {
+		Hitboxes->Refresh();
+	}
+
+	UWorld* World = GetWorld();
+	ParallelFor(NrOfTraces, [this, World](int32 Index) {
+		EPhysicalSurface SurfaceType;
+		BlockingHits[Index] = ResolveTrace(World, Hitboxes, PendingTraces[Index], Results[Index], SurfaceType);
+		SurfaceTypes[Index] = SurfaceType;
+	}, NrOfTraces < TraceBatchParallelThreshold);
+
+	for (int32 Index = 0; Index < NrOfTraces; ++Index) {
+		auto Weapon = PendingTraces[Index].Weapon.Get();
+		if (Weapon) {
+			Weapon->HandleShotTrace(PendingTraces[Index], Results[Index], BlockingHits[Index], SurfaceTypes[Index]);
+		}
+	}
+
+	PendingTraces.Reset();
+}
+
+bool ASTraceBatcher::ResolveTrace(UWorld* World, const ASHitboxRegistry* Hitboxes, const FSWeaponTrace& Trace, FHitResult& OutHit, EPhysicalSurface& OutSurfaceType) {
+	OutHit = FHitResult();
+	OutSurfaceType = SurfaceType_Default;
+	if (!World) { return false; }
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(WeaponTrace), false);
+	QueryParams.AddIgnoredActor(Trace.WeaponOwner.Get());
+	QueryParams.AddIgnoredActor(Trace.Weapon.Get());
+
+	FSHitboxHit HitboxHit;
+	if (HitboxTraces > 0 && Hitboxes && Hitboxes->Raycast(Trace.Start, Trace.End, Trace.WeaponOwner.Get(), HitboxHit)) {
+		// Only the world up to the hitbox matters, and a yes or no is enough
+		FCollisionQueryParams OcclusionParams = QueryParams;
+		OcclusionParams.AddIgnoredActor(HitboxHit.Actor);
+
+		if (!World->LineTraceTestByChannel(Trace.Start, HitboxHit.Location, COLLISION_WEAPON, OcclusionParams)) {
+			OutHit = FHitResult(HitboxHit.Actor, HitboxHit.Component, HitboxHit.Location, HitboxHit.Normal);
+			OutHit.bBlockingHit = true;
+			OutHit.Time = HitboxHit.Time;
+			OutHit.Distance = (HitboxHit.Location - Trace.Start).Size();
+			OutHit.TraceStart = Trace.Start;
+			OutHit.TraceEnd = Trace.End;
+			OutHit.BoneName = HitboxHit.BoneName;
+			OutSurfaceType = HitboxHit.SurfaceType;
+			return true;
+		}
+	}
+
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	if (!World->LineTraceSingleByChannel(OutHit, Trace.Start, Trace.End, COLLISION_WEAPON, QueryParams)) {
+		return false;
+	}
+
+	// Refine against the complex collision of the candidate component only
+	auto HitComponent = OutHit.GetComponent();
+	if (HitComponent) {
+		QueryParams.bTraceComplex = true;
+
+		FHitResult ComplexHit;
+		if (HitComponent->LineTraceComponent(ComplexHit, Trace.Start, Trace.End, QueryParams)) {
+			OutHit = ComplexHit;
+		} else if (!World->LineTraceSingleByChannel(OutHit, Trace.Start, Trace.End, COLLISION_WEAPON, QueryParams)) {
+			// The simple hull was hit but the complex geometry wasn't, and nothing else is behind it
+			return false;
+		}
+	}
+
+	OutSurfaceType = UPhysicalMaterial::DetermineSurfaceType(OutHit.PhysMaterial.Get());
+	return true;
+}
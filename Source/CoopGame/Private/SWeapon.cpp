@@ -6,10 +6,23 @@
 #include "Kismet/GameplayStatics.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Particles/ParticleSystemComponent.h"
-#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "CoopGame.h"
 #include "TimerManager.h"
 #include "UnrealNetwork.h"
+#include "STraceBatcher.h"
+#include "SHitboxRegistry.h"
+#include "SSpikeCatcher.h"
+#include "SMemoryTags.h"
+#include "SProjectileManager.h"
+#include "SSurfaceSettings.h"
+#include "SNetStats.h"
+#include "SRPCGovernor.h"
+#include "SHealthComponent.h"
+#include "SEffectStackComponent.h"
+#include "SAssetPreloader.h"
+#include "Camera/PlayerCameraManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Owner Feedback"), STAT_WeaponOwnerFeedback, STATGROUP_CoopGame);
 
 static int32 DebugWeaponDrawing = 0;
 FAutoConsoleVariableRef CVARDebugWeaponDrawing(
@@ -19,6 +32,30 @@ FAutoConsoleVariableRef CVARDebugWeaponDrawing(
 	ECVF_Cheat
 );
 
+static int32 BatchWeaponTraces = 1;
+FAutoConsoleVariableRef CVARBatchWeaponTraces(
+	TEXT("COOP.BatchWeaponTraces"),
+	BatchWeaponTraces,
+	TEXT("Resolve weapon traces through the per-frame trace batcher instead of immediately"),
+	ECVF_Default
+);
+
+static float FireRateTolerance = 1.2f;
+FAutoConsoleVariableRef CVARFireRateTolerance(
+	TEXT("COOP.FireRateTolerance"),
+	FireRateTolerance,
+	TEXT("How much faster than RateOfFire the server accepts a client's shots, to absorb network jitter"),
+	ECVF_Default
+);
+
+static float FireRateBurst = 3.f;
+FAutoConsoleVariableRef CVARFireRateBurst(
+	TEXT("COOP.FireRateBurst"),
+	FireRateBurst,
+	TEXT("Shots a client may fire back to back when its ServerFire calls arrive bunched up"),
+	ECVF_Default
+);
+
 // Sets default values
 ASWeapon::ASWeapon()
 {
@@ -29,96 +66,269 @@ ASWeapon::ASWeapon()
 	TracerTargetName = "Target";
 	BaseDamage = 20.f;
 	BulletSpread = 1.f;
+	RecoilPitch = 0.f;
+	FireTokens = 0.f;
+	LastFireTokenTime = 0.f;
 	RateOfFire = 600.f;
+	PelletCount = 1;
+	DefaultFireMode = ESWeaponFireMode::HitScan;
+
+	FireRoutine = nullptr;
+	DamageRoutine = nullptr;
 
 	SetReplicates(true);
-	NetUpdateFrequency = 66.f;
-	MinNetUpdateFrequency = 33.f;
+	// HitScanShot is pushed with ForceNetUpdate on every shot, nothing else changes between shots
+	NetUpdateFrequency = 10.f;
+	MinNetUpdateFrequency = 2.f;
 }
 
 void ASWeapon::Fire() {
 	if (Role < ROLE_Authority) {
 		ServerFire();
+		FSNetStats::Get().RecordRPCSent(this, GET_FUNCTION_NAME_CHECKED(ASWeapon, ServerFire));
 	}
 
 	auto WeaponOwner = GetOwner();
 
-	if (WeaponOwner) {
-		// OutParams
-		FHitResult Hit;
+	if (WeaponOwner && FireRoutine) {
 		FVector EyeLocation;
 		FRotator EyeRotation;
 
 		WeaponOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
-		FVector ShotDirection = EyeRotation.Vector();
 
-		float HalfRad = FMath::DegreesToRadians(BulletSpread);
+		(this->*FireRoutine)(WeaponOwner, EyeLocation, EyeRotation);
+
+		PlayOwnerFeedback();
+
+		LastFiredTime = GetWorld()->TimeSeconds;
+	}
+}
+
+template<bool bMultiPellet>
+void ASWeapon::FireHitScan(AActor* WeaponOwner, const FVector& EyeLocation, const FRotator& EyeRotation) {
+	const FVector AimDirection = EyeRotation.Vector();
+	const int32 NrOfPellets = bMultiPellet ? Config.PelletCount : 1;
+
+	for (int32 PelletIndex = 0; PelletIndex < NrOfPellets; ++PelletIndex) {
+		FSWeaponTrace Trace;
+		Trace.PelletIndex = PelletIndex;
+		Trace.Weapon = this;
+		Trace.WeaponOwner = WeaponOwner;
+		Trace.Start = EyeLocation;
 
 		// Add bullet spread
-		ShotDirection = FMath::VRandCone(ShotDirection, HalfRad, HalfRad);
+		Trace.ShotDirection = FMath::VRandCone(AimDirection, Config.SpreadHalfRad, Config.SpreadHalfRad);
+		Trace.End = EyeLocation + Trace.ShotDirection * 10000;
+
+		if (BatchWeaponTraces > 0 && TraceBatcher) {
+			TraceBatcher->QueueTrace(Trace);
+		} else {
+			if (Hitboxes) {
+				Hitboxes->Refresh();
+			}
 
-		FVector TraceEnd = EyeLocation + ShotDirection * 10000;
+			FSFrameCounters::Get(this).WeaponTraces++;
 
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(WeaponOwner);
-		QueryParams.AddIgnoredActor(this);
-		QueryParams.bTraceComplex = true;
-		QueryParams.bReturnPhysicalMaterial = true;
+			FHitResult Hit;
+			EPhysicalSurface SurfaceType;
+			bool bBlockingHit = ASTraceBatcher::ResolveTrace(GetWorld(), Hitboxes, Trace, Hit, SurfaceType);
+			HandleShotTrace(Trace, Hit, bBlockingHit, SurfaceType);
+		}
+	}
+}
 
-		// Tracer particle "Target" param
-		FVector TracerEndPoint = TraceEnd;
-		EPhysicalSurface SurfaceType = SurfaceType_Default;
+void ASWeapon::FireProjectile(AActor* WeaponOwner, const FVector& EyeLocation, const FRotator& EyeRotation) {
+	// Projectiles are only simulated authoritatively, clients see them through the manager's spawn events
+	if (Role < ROLE_Authority || !ProjectileManager) { return; }
 
-		if (GetWorld()->LineTraceSingleByChannel(Hit, EyeLocation, TraceEnd, COLLISION_WEAPON, QueryParams)) {
-			auto HitActor = Hit.GetActor();
+	auto MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
 
-			TracerEndPoint = Hit.ImpactPoint;
+	ProjectileManager->SpawnProjectile(this, MuzzleLocation, EyeRotation.Vector());
+}
 
-			SurfaceType = UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
+template<bool bDamageFalloff>
+float ASWeapon::ComputeShotDamage(const FHitResult& Hit, EPhysicalSurface SurfaceType) const {
+	float Damage = Config.BaseDamage * Config.SurfaceDamageMultipliers[SurfaceType];
 
-			float ActualDamage = BaseDamage;
+	if (bDamageFalloff) {
+		Damage *= Config.DamageFalloff->Eval(Hit.Distance, 1.f);
+	}
 
-			if (SurfaceType == SURFACE_FLESHVULNERABLE) {
-				ActualDamage *= 4.f;
-			}
+	return Damage;
+}
+
+void ASWeapon::ResolveWeaponConfig() {
+	float FireRate;
+	float Spread;
+
+	// Legacy weapons keep their per-property config
+	if (WeaponData) {
+		Config.FireMode = WeaponData->FireMode;
+		Config.BaseDamage = WeaponData->BaseDamage;
+		Config.PelletCount = FMath::Max(WeaponData->PelletCount, 1);
+		Config.DamageType = WeaponData->DamageType;
+		FireRate = WeaponData->RateOfFire;
+		Spread = WeaponData->BulletSpread;
+
+		const FRichCurve* Falloff = WeaponData->DamageFalloff.GetRichCurveConst();
+		Config.DamageFalloff = Falloff && Falloff->GetNumKeys() > 0 ? Falloff : nullptr;
+	} else {
+		Config.FireMode = DefaultFireMode;
+		Config.BaseDamage = BaseDamage;
+		Config.PelletCount = FMath::Max(PelletCount, 1);
+		Config.DamageType = DamageType;
+		Config.DamageFalloff = nullptr;
+		FireRate = RateOfFire;
+		Spread = BulletSpread;
+	}
 
-			UGameplayStatics::ApplyPointDamage(
-				HitActor,
-				ActualDamage,
-				ShotDirection,
-				Hit,
-				WeaponOwner->GetInstigatorController(),
-				WeaponOwner,
-				DamageType
-			);
+	Config.SpreadHalfRad = FMath::DegreesToRadians(Spread);
 
-			PlayImpactEffects(SurfaceType, Hit.ImpactPoint);
+	const FSSurfaceTable& SurfaceTable = USSurfaceSettings::GetTable();
 
-			TracerEndPoint = Hit.ImpactPoint;
-		}
+	for (int32 SurfaceIndex = 0; SurfaceIndex < SurfaceType_Max; ++SurfaceIndex) {
+		Config.SurfaceDamageMultipliers[SurfaceIndex] = SurfaceTable.DamageMultipliers[SurfaceIndex];
+
+		const bool bIsFlesh = SurfaceIndex == SURFACE_FLESHDEFAULT || SurfaceIndex == SURFACE_FLESHVULNERABLE;
+		const TSoftObjectPtr<UParticleSystem>* WeaponEffect = bIsFlesh ? &FleshImpactEffect : &DefaultImpactEffect;
+		Config.FallbackImpactEffects[SurfaceIndex] = SurfaceTable.ImpactEffects[SurfaceIndex] ? nullptr : WeaponEffect;
+	}
 
-		if (DebugWeaponDrawing > 0) {
-			DrawDebugLine(GetWorld(), EyeLocation, TraceEnd, FColor::Red, false, 2.f, 0, 2.f);
+	if (WeaponData) {
+		for (const FSSurfaceDamageMultiplier& Entry : WeaponData->SurfaceDamageMultipliers) {
+			Config.SurfaceDamageMultipliers[Entry.SurfaceType] *= Entry.Multiplier;
 		}
+	}
 
-		PlayFireEffects(TracerEndPoint);
+	TimeBetweenShots = 60 / FMath::Max(FireRate, 1.f);
+
+	switch (Config.FireMode) {
+	case ESWeaponFireMode::Projectile:
+		FireRoutine = &ASWeapon::FireProjectile;
+		break;
+	default:
+		FireRoutine = Config.PelletCount > 1 ? &ASWeapon::FireHitScan<true> : &ASWeapon::FireHitScan<false>;
+		break;
+	}
+
+	DamageRoutine = Config.DamageFalloff ? &ASWeapon::ComputeShotDamage<true> : &ASWeapon::ComputeShotDamage<false>;
+}
+
+const FSProjectileParams* ASWeapon::GetProjectileParams() const {
+	return WeaponData ? &WeaponData->ProjectileParams : nullptr;
+}
+
+void ASWeapon::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	OutAssets.Add(MuzzleEffect.ToSoftObjectPath());
+	OutAssets.Add(TracerEffect.ToSoftObjectPath());
+	OutAssets.Add(DefaultImpactEffect.ToSoftObjectPath());
+	OutAssets.Add(FleshImpactEffect.ToSoftObjectPath());
+	OutAssets.Add(FireCamShake.ToSoftObjectPath());
+}
+
+void ASWeapon::HandleShotTrace(const FSWeaponTrace& Trace, const FHitResult& Hit, bool bBlockingHit, EPhysicalSurface SurfaceType) {
+	auto WeaponOwner = Trace.WeaponOwner.Get();
+	if (!WeaponOwner) { return; }
+
+	// Tracer particle "Target" param
+	FVector TracerEndPoint = Trace.End;
+
+	if (bBlockingHit) {
+		auto HitActor = Hit.GetActor();
+
+		float ActualDamage = (this->*DamageRoutine)(Hit, SurfaceType) * USEffectStackComponent::GetDamageMultiplier(WeaponOwner);
+
+		UGameplayStatics::ApplyPointDamage(
+			HitActor,
+			ActualDamage,
+			Trace.ShotDirection,
+			Hit,
+			WeaponOwner->GetInstigatorController(),
+			WeaponOwner,
+			Config.DamageType
+		);
 
-		
+		PlayImpactEffects(SurfaceType, Hit.ImpactPoint);
 
-		if (Role==ROLE_Authority) {
-			HitScanTrace.TraceTo = TracerEndPoint;
-			HitScanTrace.SurfaceType = SurfaceType;
+		TracerEndPoint = Hit.ImpactPoint;
+	}
+
+	if (DebugWeaponDrawing > 0) {
+		DrawDebugLine(GetWorld(), Trace.Start, Trace.End, FColor::Red, false, 2.f, 0, 2.f);
+	}
+
+	// Muzzle flash once per shot, a tracer per pellet
+	if (Trace.PelletIndex == 0) {
+		PlayFireEffects(TracerEndPoint);
+	} else {
+		PlayTracerEffect(TracerEndPoint);
+	}
+
+	if (Role==ROLE_Authority) {
+		// Pellets of a shot are resolved in order, the first one starts the shot over
+		if (Trace.PelletIndex == 0) {
+			HitScanShot.ShotCount++;
+			HitScanShot.Pellets.Reset();
 		}
 
-		LastFiredTime = GetWorld()->TimeSeconds;
+		FHitScanTrace& Pellet = HitScanShot.Pellets[HitScanShot.Pellets.AddDefaulted()];
+		Pellet.TraceTo = TracerEndPoint;
+		Pellet.SurfaceType = SurfaceType;
+		FSNetStats::Get().RecordPropertySent(this, GET_MEMBER_NAME_CHECKED(ASWeapon, HitScanShot), true);
+		ForceNetUpdate();
 	}
 }
 
 void ASWeapon::ServerFire_Implementation() {
+	FSNetStats::Get().RecordRPCReceived(this, GET_FUNCTION_NAME_CHECKED(ASWeapon, ServerFire));
+
+	// Fast firing weapons need more calls a second than the connection's default budget
+	if (!FSRPCGovernor::Get().ConsumeServerRPC(this, GET_FUNCTION_NAME_CHECKED(ASWeapon, ServerFire), GetMaxServerShotsPerSecond())) { return; }
+
+	const TCHAR* RejectReason = nullptr;
+	if (!CanServerFire(RejectReason)) {
+		FSRPCGovernor::Get().RecordRejected(this, GET_FUNCTION_NAME_CHECKED(ASWeapon, ServerFire), RejectReason);
+		return;
+	}
+
 	Fire();
 }
 
 bool ASWeapon::ServerFire_Validate() {
+	// Failing validation kicks the client, and jitter alone can push honest clients over the fire rate,
+	// so excess shots are dropped in the implementation instead
+	return true;
+}
+
+float ASWeapon::GetMaxServerShotsPerSecond() const {
+	// TimeBetweenShots comes from the weapon data when there is one, RateOfFire alone only covers legacy weapons
+	return FMath::Max(FireRateTolerance, 1.f) / FMath::Max(TimeBetweenShots, KINDA_SMALL_NUMBER);
+}
+
+bool ASWeapon::CanServerFire(const TCHAR*& OutReason) {
+	auto WeaponOwner = Cast<APawn>(GetOwner());
+	if (!WeaponOwner || !WeaponOwner->GetController()) {
+		OutReason = TEXT("weapon not held");
+		return false;
+	}
+
+	auto HealthComp = Cast<USHealthComponent>(WeaponOwner->GetComponentByClass(USHealthComponent::StaticClass()));
+	if (HealthComp && HealthComp->GetHealth() <= 0.f) {
+		OutReason = TEXT("owner is dead");
+		return false;
+	}
+
+	const float Now = GetWorld()->TimeSeconds;
+	const float ShotsPerSecond = GetMaxServerShotsPerSecond();
+	FireTokens = FMath::Min(FireTokens + (Now - LastFireTokenTime) * ShotsPerSecond, FMath::Max(FireRateBurst, 1.f));
+	LastFireTokenTime = Now;
+
+	if (FireTokens < 1.f) {
+		OutReason = TEXT("over fire rate");
+		return false;
+	}
+
+	FireTokens -= 1.f;
 	return true;
 }
 
@@ -133,71 +343,100 @@ void ASWeapon::StopFire() {
 	GetWorldTimerManager().ClearTimer(TimerHandle_TimeBetweenShots);
 }
 
-void ASWeapon::OnRep_HitScanTrace() {
-	// Play cosmetic effects
-	PlayFireEffects(HitScanTrace.TraceTo);
-	PlayImpactEffects(HitScanTrace.SurfaceType, HitScanTrace.TraceTo);
+void ASWeapon::OnRep_HitScanShot() {
+	FSNetStats::Get().RecordPropertyReceived(this, GET_MEMBER_NAME_CHECKED(ASWeapon, HitScanShot));
+
+	// Play cosmetic effects, muzzle flash once per shot and a tracer per pellet
+	for (int32 PelletIndex = 0; PelletIndex < HitScanShot.Pellets.Num(); ++PelletIndex) {
+		const FHitScanTrace& Pellet = HitScanShot.Pellets[PelletIndex];
+		if (PelletIndex == 0) {
+			PlayFireEffects(Pellet.TraceTo);
+		} else {
+			PlayTracerEffect(Pellet.TraceTo);
+		}
+		PlayImpactEffects(Pellet.SurfaceType, Pellet.TraceTo);
+	}
 }
 
 void ASWeapon::BeginPlay() {
+	COOP_LLM_SCOPE(ESMemoryTag::Weapons);
 	Super::BeginPlay();
 
-	TimeBetweenShots = 60 / RateOfFire;
+	ResolveWeaponConfig();
+
+	if (Config.FireMode == ESWeaponFireMode::HitScan) {
+		TraceBatcher = ASTraceBatcher::Get(GetWorld());
+		Hitboxes = ASHitboxRegistry::Get(GetWorld());
+	} else if (HasAuthority()) {
+		ProjectileManager = ASProjectileManager::Get(GetWorld());
+	}
+
+	// Normally already streamed in by the game state before the match, this catches weapons it didn't know about
+	if (auto Preloader = ASAssetPreloader::Get(GetWorld())) {
+		Preloader->PreloadClass(GetClass());
+	}
 }
 
 void ASWeapon::PlayFireEffects(FVector TracerEndPoint) {
+	// Nobody watches a dedicated server, remote players play their own muzzle and tracer when they fire locally
+	if (GetNetMode() == NM_DedicatedServer) { return; }
 
-	if (MuzzleEffect) {
-		UGameplayStatics::SpawnEmitterAttached(MuzzleEffect, MeshComp, MuzzleSocketName);
-	}
+	COOP_LLM_SCOPE(ESMemoryTag::Effects);
 
-	if (TracerEffect) {
-		FVector MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
-		auto TracerComp = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), TracerEffect, MuzzleLocation);
-		if (TracerComp) {
-			TracerComp->SetVectorParameter(TracerTargetName, TracerEndPoint);
-		}
+	// Soft references that haven't finished streaming in are skipped rather than loaded mid-fight
+	if (auto Muzzle = MuzzleEffect.Get()) {
+		UGameplayStatics::SpawnEmitterAttached(Muzzle, MeshComp, MuzzleSocketName);
 	}
 
+	PlayTracerEffect(TracerEndPoint);
+}
+
+void ASWeapon::PlayOwnerFeedback() {
+	// The owning client runs Fire from its own fire timer, so the server never has to send it anything for this
 	auto WeaponOwner = Cast<APawn>(GetOwner());
+	if (!WeaponOwner || !WeaponOwner->IsLocallyControlled()) { return; }
 
-	if (WeaponOwner) {
-		auto PC = Cast<APlayerController>(WeaponOwner->GetController());
-		if (PC) {
-			PC->ClientPlayCameraShake(FireCamShake);
+	auto PC = Cast<APlayerController>(WeaponOwner->GetController());
+	if (!PC) { return; }
+
+	INC_DWORD_STAT(STAT_WeaponOwnerFeedback);
+
+	// Straight on the local camera manager, ClientPlayCameraShake is an RPC wherever the controller isn't local
+	if (PC->PlayerCameraManager && FireCamShake.Get()) {
+		PC->PlayerCameraManager->PlayCameraShake(FireCamShake.Get());
+	}
+
+	if (RecoilPitch != 0.f) {
+		PC->SetControlRotation(PC->GetControlRotation() + FRotator(RecoilPitch, 0.f, 0.f));
+	}
+}
+
+void ASWeapon::PlayTracerEffect(FVector TracerEndPoint) {
+	if (GetNetMode() == NM_DedicatedServer) { return; }
+
+	if (auto Tracer = TracerEffect.Get()) {
+		COOP_LLM_SCOPE(ESMemoryTag::Effects);
+		FVector MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
+		auto TracerComp = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Tracer, MuzzleLocation);
+		if (TracerComp) {
+			TracerComp->SetVectorParameter(TracerTargetName, TracerEndPoint);
 		}
 	}
 }
 
 void ASWeapon::PlayImpactEffects(EPhysicalSurface SurfaceType, FVector ImpactPoint) {
-	UParticleSystem* SelectedEffect = nullptr;
+	if (GetNetMode() == NM_DedicatedServer) { return; }
 
-	switch (SurfaceType) {
-	case SURFACE_FLESHDEFAULT:
-	case SURFACE_FLESHVULNERABLE:
-		SelectedEffect = FleshImpactEffect;
-		break;
-	default:
-		SelectedEffect = DefaultImpactEffect;
-		break;
-	}
+	FVector MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
+	FVector ShotDirection = ImpactPoint - MuzzleLocation;
+	ShotDirection.Normalize();
 
-	if (SelectedEffect) {
-		FVector MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
-		FVector ShotDirection = ImpactPoint - MuzzleLocation;
-		ShotDirection.Normalize();
-
-		UGameplayStatics::SpawnEmitterAtLocation(
-			GetWorld(),
-			SelectedEffect,
-			ImpactPoint,
-			ShotDirection.Rotation()
-		);
-	}
+	auto FallbackEffect = Config.FallbackImpactEffects[SurfaceType];
+	USSurfaceSettings::GetTable().PlayImpact(this, SurfaceType, ImpactPoint, ShotDirection.Rotation(), FallbackEffect ? FallbackEffect->Get() : nullptr);
 }
 
 void ASWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(ASWeapon, HitScanTrace, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ASWeapon, HitScanShot, COND_SkipOwner);
 }
@@ -0,0 +1,10 @@
+#include "SWeaponData.h"
+
+
+USWeaponData::USWeaponData() {
+	FireMode = ESWeaponFireMode::HitScan;
+	RateOfFire = 600.f;
+	BaseDamage = 20.f;
+	BulletSpread = 1.f;
+	PelletCount = 1;
+}
@@ -0,0 +1,131 @@
+#include "SBotRenderer.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSInstanceSlotsAllocTest, "CoopGame.BotRenderer.InstanceSlots.Alloc",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSInstanceSlotsAllocTest::RunTest(const FString& Parameters) {
+	FSInstanceSlots Slots;
+
+	const int32 A = Slots.Add();
+	const int32 B = Slots.Add();
+	const int32 C = Slots.Add();
+
+	TestEqual(TEXT("Instances"), Slots.Num(), 3);
+	TestEqual(TEXT("First index"), Slots.GetIndex(A), 0);
+	TestEqual(TEXT("Second index"), Slots.GetIndex(B), 1);
+	TestEqual(TEXT("Third index"), Slots.GetIndex(C), 2);
+	TestEqual(TEXT("Unknown handle"), Slots.GetIndex(C + 1), (int32)INDEX_NONE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSInstanceSlotsFreeTest, "CoopGame.BotRenderer.InstanceSlots.Free",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSInstanceSlotsFreeTest::RunTest(const FString& Parameters) {
+	FSInstanceSlots Slots;
+
+	const int32 A = Slots.Add();
+	const int32 B = Slots.Add();
+
+	// The last instance leaves nothing to move
+	TestEqual(TEXT("Hole after removing the last"), Slots.Remove(B), (int32)INDEX_NONE);
+	TestEqual(TEXT("Instances"), Slots.Num(), 1);
+	TestEqual(TEXT("Freed handle"), Slots.GetIndex(B), (int32)INDEX_NONE);
+	TestEqual(TEXT("Removing twice"), Slots.Remove(B), (int32)INDEX_NONE);
+
+	// Freed handles are handed out again, at the end
+	const int32 Reused = Slots.Add();
+	TestEqual(TEXT("Reused handle"), Reused, B);
+	TestEqual(TEXT("Reused index"), Slots.GetIndex(Reused), 1);
+	TestEqual(TEXT("Untouched index"), Slots.GetIndex(A), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSInstanceSlotsSwapRemoveTest, "CoopGame.BotRenderer.InstanceSlots.SwapRemove",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSInstanceSlotsSwapRemoveTest::RunTest(const FString& Parameters) {
+	FSInstanceSlots Slots;
+
+	const int32 A = Slots.Add();
+	const int32 B = Slots.Add();
+	const int32 C = Slots.Add();
+	const int32 D = Slots.Add();
+
+	// The last instance moves into the hole, the others keep their index
+	TestEqual(TEXT("Hole"), Slots.Remove(B), 1);
+	TestEqual(TEXT("Instances"), Slots.Num(), 3);
+	TestEqual(TEXT("Moved index"), Slots.GetIndex(D), 1);
+	TestEqual(TEXT("First index"), Slots.GetIndex(A), 0);
+	TestEqual(TEXT("Third index"), Slots.GetIndex(C), 2);
+
+	TestEqual(TEXT("Hole at the front"), Slots.Remove(A), 0);
+	TestEqual(TEXT("Moved to the front"), Slots.GetIndex(C), 0);
+	TestEqual(TEXT("Moved earlier"), Slots.GetIndex(D), 1);
+
+	// Every index is still used by exactly one handle
+	TestNotEqual(TEXT("Dense indices"), Slots.GetIndex(C), Slots.GetIndex(D));
+	TestEqual(TEXT("Instances left"), Slots.Num(), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSBotRendererBucketReuseTest, "CoopGame.BotRenderer.BucketReuse",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSBotRendererBucketReuseTest::RunTest(const FString& Parameters) {
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	auto Renderer = World ? World->SpawnActor<ASBotRenderer>() : nullptr;
+	if (!TestNotNull(TEXT("Renderer"), Renderer)) {
+		if (World) {
+			World->DestroyWorld(false);
+		}
+		return false;
+	}
+
+	UMaterialInterface* Material = UMaterial::GetDefaultMaterial(MD_Surface);
+
+	ASBotRenderer::FBucketKey Key;
+	Key.Mesh = nullptr;
+	Key.Material = Material;
+	Key.PowerLevel = 1;
+	Key.bPulsing = false;
+
+	const int32 Bucket = Renderer->FindOrAddBucket(Key);
+	TestEqual(TEXT("Same key, same bucket"), Renderer->FindOrAddBucket(Key), Bucket);
+	TestEqual(TEXT("Buckets"), Renderer->Buckets.Num(), 1);
+
+	UMaterialInstanceDynamic* SharedMaterial = Renderer->Buckets[Bucket].Material;
+	if (TestNotNull(TEXT("Shared material"), SharedMaterial)) {
+		TestEqual(TEXT("Shared material parent"), SharedMaterial->Parent, Material);
+	}
+
+	// Power level and pulsing each need their own material
+	ASBotRenderer::FBucketKey PoweredKey = Key;
+	PoweredKey.PowerLevel = 2;
+	const int32 PoweredBucket = Renderer->FindOrAddBucket(PoweredKey);
+
+	ASBotRenderer::FBucketKey PulsingKey = Key;
+	PulsingKey.bPulsing = true;
+	const int32 PulsingBucket = Renderer->FindOrAddBucket(PulsingKey);
+
+	TestEqual(TEXT("Buckets"), Renderer->Buckets.Num(), 3);
+	TestNotEqual(TEXT("Power level bucket"), PoweredBucket, Bucket);
+	TestNotEqual(TEXT("Pulsing bucket"), PulsingBucket, Bucket);
+	TestTrue(TEXT("Power level material"), Renderer->Buckets[PoweredBucket].Material != SharedMaterial);
+	TestTrue(TEXT("Pulsing material"), Renderer->Buckets[PulsingBucket].Material != SharedMaterial);
+	TestEqual(TEXT("Power level bucket reused"), Renderer->FindOrAddBucket(PoweredKey), PoweredBucket);
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
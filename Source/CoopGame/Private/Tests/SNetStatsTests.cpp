@@ -0,0 +1,31 @@
+#include "SNetStats.h"
+#include "SWeapon.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSNetStatsHitScanShotTest, "CoopGame.NetStats.MeasureHitScanShot",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSNetStatsHitScanShotTest::RunTest(const FString& Parameters) {
+	FHitScanShot Shot;
+	const int32 EmptyBits = FSNetStats::MeasureStructBits(FHitScanShot::StaticStruct(), &Shot);
+	TestTrue(TEXT("Empty shot has a count and a shot counter"), EmptyBits > 0);
+
+	FHitScanTrace Pellet;
+	Pellet.SurfaceType = SurfaceType_Default;
+	Pellet.TraceTo = FVector(100.f, 200.f, 300.f);
+	const int32 PelletBits = FSNetStats::MeasureStructBits(FHitScanTrace::StaticStruct(), &Pellet);
+	TestTrue(TEXT("Pellet bits"), PelletBits > 0);
+
+	// Goes through the array path, which must not net serialize the array as a whole
+	for (int32 Index = 0; Index < 3; ++Index) {
+		Shot.Pellets.Add(Pellet);
+	}
+
+	TestEqual(TEXT("Every pellet is measured"), FSNetStats::MeasureStructBits(FHitScanShot::StaticStruct(), &Shot), EmptyBits + 3 * PelletBits);
+
+	return true;
+}
+
+#endif
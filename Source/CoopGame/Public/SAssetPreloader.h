@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SAssetPreloader.generated.h"
+
+class APawn;
+struct FStreamableHandle;
+
+/**
+ * Streams in the soft referenced cosmetic assets of ISPreloadable classes ahead of use.
+ * While waiting for a wave to start it loads the assets of the upcoming bot classes and of every
+ * preloadable actor in the world, and releases the assets of classes that are no longer needed.
+ * Does nothing on dedicated servers, which never need cosmetics.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASAssetPreloader : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASAssetPreloader();
+
+	// Null on dedicated servers
+	static ASAssetPreloader* Get(UWorld* World);
+
+	// Starts streaming the class's assets unless they are already loaded or loading
+	void PreloadClass(UClass* Class);
+
+	void PrepareForWave(const TArray<TSubclassOf<APawn>>& UpcomingBotClasses);
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	TMap<TWeakObjectPtr<UClass>, TSharedPtr<FStreamableHandle>> Handles;
+};
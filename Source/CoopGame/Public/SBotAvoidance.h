@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SBotAvoidance.generated.h"
+
+class ASTrackerBot;
+
+/**
+ * Steers tracker bots around each other before physics, so dense swarms spread out instead of piling into rigid body
+ * contacts. Runs once per frame over all bots: positions and velocities are gathered into flat arrays, bucketed into a
+ * uniform grid, and each bot is pushed away from the neighbours it is about to come closest to within a short time
+ * horizon. Bots add the result to their steering direction. Server only.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASBotAvoidance : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASBotAvoidance();
+
+	// Null on clients
+	static ASBotAvoidance* Get(UWorld* World);
+
+	void RegisterBot(ASTrackerBot* Bot);
+
+	void UnregisterBot(ASTrackerBot* Bot);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Averages frame time, avoidance time and bot contacts over the next NrOfFrames frames and logs them
+	void StartBenchmark(int32 NrOfFrames);
+
+protected:
+	// Fills Avoidance for every gathered bot, returns the number of bot pairs in contact
+	int32 ComputeAvoidance();
+
+	TArray<TWeakObjectPtr<ASTrackerBot>> Bots;
+
+	// Active bots of this frame, one entry per bot in each array
+	TArray<ASTrackerBot*> ActiveBots;
+	TArray<FVector2D> Positions;
+	TArray<FVector2D> Velocities;
+	TArray<float> Radii;
+	TArray<FVector2D> Avoidance;
+
+	// First bot in each grid cell, the rest are chained through NextInCell
+	TMap<FIntPoint, int32> CellHeads;
+	TArray<int32> NextInCell;
+
+	int32 BenchmarkFramesLeft;
+	int32 BenchmarkFrames;
+	double BenchmarkFrameTime;
+	double BenchmarkAvoidanceTime;
+	int64 BenchmarkBots;
+	int64 BenchmarkContacts;
+};
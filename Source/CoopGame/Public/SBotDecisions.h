@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "SBotDecisions.generated.h"
+
+class ASTrackerBot;
+class ASBotDecisions;
+
+// What a bot's decision depends on, copied from the bot on the game thread
+struct FSBotDecisionInput {
+	FVector Location;
+	FVector NextPathPoint;
+	float Radius;
+	float RequiredDistanceToTarget;
+	float SelfDestructRadius;
+	float TimeSinceLastPath;
+	uint8 TeamNum;
+	bool bCanSelfDestruct;
+	bool bCheckPowerLevel;
+};
+
+// A living pawn with a health component that bots could chase
+struct FSBotDecisionTarget {
+	FVector Location;
+	float Radius;
+	float HalfHeight;
+	uint8 TeamNum;
+
+	// Only players set off a bot's self destruction
+	bool bTriggersSelfDestruct;
+};
+
+struct FSBotDecision {
+	// Index into the frame's targets, INDEX_NONE if there is nothing to chase
+	int32 Target = INDEX_NONE;
+
+	bool bRefreshPath = false;
+	bool bSelfDestruct = false;
+
+	// INDEX_NONE unless the power level was checked this frame
+	int32 PowerLevel = INDEX_NONE;
+};
+
+// Commits the decisions in a later tick group than the one that started them
+USTRUCT()
+struct FSBotDecisionCommitTickFunction : public FTickFunction {
+	GENERATED_BODY()
+
+	ASBotDecisions* Target;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSBotDecisionCommitTickFunction> : public TStructOpsTypeTraitsBase2<FSBotDecisionCommitTickFunction> {
+	enum { WithCopy = false };
+};
+
+/**
+ * Makes the tracker bots' decisions for the frame: which player to chase, when to find a new path, when to start self
+ * destructing and how many bots are nearby. In TG_PrePhysics the state these depend on is copied into flat arrays and
+ * every bot is evaluated on worker threads while physics runs. In TG_PostPhysics the results are applied on the game
+ * thread in registration order, so a frame's decisions don't depend on thread timing. Server only.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASBotDecisions : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASBotDecisions();
+
+	// Null on clients
+	static ASBotDecisions* Get(UWorld* World);
+
+	void RegisterBot(ASTrackerBot* Bot);
+
+	void UnregisterBot(ASTrackerBot* Bot);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Waits for the evaluation started this frame and applies it
+	void CommitDecisions();
+
+	// Bots that were neither pooled nor exploded at this frame's snapshot
+	int32 GetNrOfActiveBots() const { return Inputs.Num(); }
+
+protected:
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void Snapshot();
+
+	// Reads the snapshot only, safe to call from worker threads
+	void EvaluateBot(int32 Index);
+
+	FSBotDecisionCommitTickFunction CommitTick;
+
+	TArray<TWeakObjectPtr<ASTrackerBot>> Bots;
+
+	// Bots evaluated this frame, in registration order
+	TArray<TWeakObjectPtr<ASTrackerBot>> SnapshotBots;
+	TArray<FSBotDecisionInput> Inputs;
+	TArray<FSBotDecision> Decisions;
+
+	TArray<TWeakObjectPtr<APawn>> SnapshotTargets;
+	TArray<FSBotDecisionTarget> Targets;
+
+	FGraphEventRef EvaluateTask;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
+#include "SBotMovementReplicator.generated.h"
+
+class ASTrackerBot;
+class APlayerController;
+
+// Position and velocity of one bot, quantized to whole centimetres
+USTRUCT()
+struct FSBotMovementUpdate {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	ASTrackerBot* Bot;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantize Velocity;
+
+	// NetGUID plus two packed vectors at around 20 bits per component, for net stats
+	static const int32 ApproxBits = 32 + 2 * 65;
+};
+
+/**
+ * Replicates tracker bot movement in place of the default replicated movement, which sends full transforms and
+ * velocities of every bot at the bot's update rate to every client. Each client gets one batched unreliable RPC
+ * per frame holding only the bots due an update for it, sent more often the closer a bot is to that player.
+ * Clients interpolate between updates with the bots' physics disabled. Server only.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASBotMovementReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASBotMovementReplicator();
+
+	// Null on clients
+	static ASBotMovementReplicator* Get(UWorld* World);
+
+	void RegisterBot(ASTrackerBot* Bot);
+
+	void UnregisterBot(ASTrackerBot* Bot);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	struct FBotSendState {
+		float NextSendTime = 0.f;
+		FVector LastSentLocation = FVector::ZeroVector;
+		bool bWasMoving = true;
+	};
+
+	// Send state of every bot for one client
+	struct FClientState {
+		TMap<TWeakObjectPtr<ASTrackerBot>, FBotSendState> Bots;
+	};
+
+	void ReplicateTo(APlayerController* PC, FClientState& Client, float Now);
+
+	TArray<TWeakObjectPtr<ASTrackerBot>> Bots;
+
+	TMap<TWeakObjectPtr<APlayerController>, FClientState> Clients;
+
+	TArray<FSBotMovementUpdate> PendingUpdates;
+};
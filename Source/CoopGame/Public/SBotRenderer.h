@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SBotRenderer.generated.h"
+
+class ASTrackerBot;
+class UStaticMesh;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Keeps instance indices dense as instances come and go. Every instance gets a stable handle, and removing one
+ * moves the last instance into its place so the instanced component never shifts the indices after it.
+ */
+struct COOPGAME_API FSInstanceSlots {
+	// Handle of a new instance at index Num() - 1
+	int32 Add();
+
+	// Frees the handle. Returns the index the last instance has to be moved to before the last index is removed,
+	// or INDEX_NONE when the removed instance was the last one
+	int32 Remove(int32 Handle);
+
+	int32 GetIndex(int32 Handle) const { return HandleToIndex.IsValidIndex(Handle) ? HandleToIndex[Handle] : INDEX_NONE; }
+
+	int32 Num() const { return IndexToHandle.Num(); }
+
+private:
+	TArray<int32> HandleToIndex;
+	TArray<int32> IndexToHandle;
+	TArray<int32> FreeHandles;
+};
+
+/**
+ * Draws every tracker bot in the world through shared instanced static meshes instead of a mesh component and a
+ * dynamic material instance per bot. UE 4.20 has no per-instance custom data, so bots are bucketed by mesh, material,
+ * power level and whether they are pulsing from a hit, and each bucket has one shared dynamic material instance.
+ * Bots keep their own (hidden) mesh component for collision. Not used on dedicated servers.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASBotRenderer : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASBotRenderer();
+
+	// Null on dedicated servers
+	static ASBotRenderer* Get(UWorld* World);
+
+	// Returns false if the bot has nothing to instance and has to draw itself
+	bool RegisterBot(ASTrackerBot* Bot);
+
+	void UnregisterBot(ASTrackerBot* Bot);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	friend class FSBotRendererBucketReuseTest;
+
+	struct FBucketKey {
+		UStaticMesh* Mesh;
+		UMaterialInterface* Material;
+		int32 PowerLevel;
+		bool bPulsing;
+
+		bool operator==(const FBucketKey& Other) const {
+			return Mesh == Other.Mesh && Material == Other.Material && PowerLevel == Other.PowerLevel && bPulsing == Other.bPulsing;
+		}
+
+		friend uint32 GetTypeHash(const FBucketKey& Key) {
+			return HashCombine(HashCombine(GetTypeHash(Key.Mesh), GetTypeHash(Key.Material)), GetTypeHash(Key.PowerLevel * 2 + (Key.bPulsing ? 1 : 0)));
+		}
+	};
+
+	struct FBucket {
+		UInstancedStaticMeshComponent* Instances;
+		UMaterialInstanceDynamic* Material;
+		FSInstanceSlots Slots;
+
+		// Latest hit of any bot in the bucket, what the shared material pulses from
+		float LastTimeDamageTaken;
+
+		bool bDirty;
+	};
+
+	struct FBotEntry {
+		int32 Bucket = INDEX_NONE;
+		int32 Handle = INDEX_NONE;
+
+		// Skips resting bots, so a bucket of them doesn't rebuild its render state every frame
+		FTransform LastTransform;
+	};
+
+	int32 FindOrAddBucket(const FBucketKey& Key);
+
+	void AddInstance(FBotEntry& Entry, int32 BucketIndex, const FTransform& Transform);
+
+	void RemoveInstance(FBotEntry& Entry);
+
+	TMap<TWeakObjectPtr<ASTrackerBot>, FBotEntry> Bots;
+
+	TArray<FBucket> Buckets;
+
+	TMap<FBucketKey, int32> BucketIndices;
+
+	// Keeps the bucket components and materials alive
+	UPROPERTY(Transient)
+	TArray<UObject*> BucketObjects;
+};
@@ -10,6 +10,7 @@ class ASWeapon;
 class USpringArmComponent;
 class UCameraComponent;
 class USHealthComponent;
+class USEffectStackComponent;
 
 UCLASS()
 class COOPGAME_API ASCharacter : public ACharacter
@@ -22,10 +23,15 @@ public:
 
 	virtual FVector GetPawnViewLocation() const override;
 
+	// Takes the weapon along, a match reset destroys player pawns
+	virtual void Destroyed() override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void MoveForward(float Value);
 	void MoveRight(float Value);
 
@@ -61,12 +67,34 @@ protected:
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Player")
 	USHealthComponent* HealthComp;
 
-	UFUNCTION()
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Player")
+	USEffectStackComponent* EffectsComp;
+
 	void OnHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
 	bool bDied;
 
+	// Seconds the body stays after death, less when ASCorpseManager is over COOP.MaxCorpses
+	UPROPERTY(EditDefaultsOnly, Category = "Player", meta = (ClampMin = 0.f))
+	float CorpseLifeSpan;
+
+	// Weapon traces test these instead of the mesh's physics asset, see ASHitboxRegistry
+	UPROPERTY(EditDefaultsOnly, Category = "Hitboxes")
+	FName HeadHitboxSocket;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hitboxes", meta = (ClampMin = 0.f))
+	float HeadHitboxRadius;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hitboxes")
+	FName BodyHitboxBottomSocket;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hitboxes")
+	FName BodyHitboxTopSocket;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hitboxes", meta = (ClampMin = 0.f))
+	float BodyHitboxRadius;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SCorpseManager.generated.h"
+
+/**
+ * Keeps dead characters and exploded bots around only as long as they're needed. A corpse stops ticking, simulating
+ * and replicating as soon as it's added, and is recycled once its lifespan runs out, oldest first as soon as there
+ * are more than COOP.MaxCorpses. Server only.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASCorpseManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASCorpseManager();
+
+	// Null on clients
+	static ASCorpseManager* Get(UWorld* World);
+
+	// Freezes Corpse and recycles it after LifeSpan seconds. Recycle defaults to destroying it
+	void AddCorpse(AActor* Corpse, float LifeSpan, const FSimpleDelegate& Recycle = FSimpleDelegate());
+
+	// For corpses that are reused by something else first, such as a match reset
+	void RemoveCorpse(AActor* Corpse);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Turns off ticking, physics and replication of the actor and what's attached to it, once clients have its current state.
+	// Actors that are brought back to life turn back on what they need
+	static void Freeze(AActor* Actor);
+
+protected:
+	struct FCorpse {
+		TWeakObjectPtr<AActor> Actor;
+		float ExpireTime;
+		FSimpleDelegate Recycle;
+	};
+
+	void RecycleCorpse(int32 Index);
+
+	// Oldest first
+	TArray<FCorpse> Corpses;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SEffectData.generated.h"
+
+class UStaticMesh;
+
+UENUM(BlueprintType)
+enum class ESEffectKind : uint8 {
+	// Heals Magnitude every TickInterval for Duration
+	HealOverTime,
+	// Multiplies the damage the actor deals by Magnitude
+	DamageMultiplier,
+	// Multiplies the actor's walk speed by Magnitude
+	SpeedMultiplier
+};
+
+/**
+ * A buff a pickup grants, applied to the USEffectStackComponent of whoever picks it up. Effects of the same asset
+ * restart rather than stack, different assets combine.
+ */
+UCLASS(BlueprintType)
+class COOPGAME_API USEffectData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	USEffectData();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Effect")
+	ESEffectKind Kind;
+
+	// Health per tick, or the multiplier
+	UPROPERTY(EditDefaultsOnly, Category = "Effect")
+	float Magnitude;
+
+	// Seconds the effect lasts
+	UPROPERTY(EditDefaultsOnly, Category = "Effect", meta = (ClampMin = 0.f))
+	float Duration;
+
+	// Seconds between heals, 0 heals once
+	UPROPERTY(EditDefaultsOnly, Category = "Effect", meta = (ClampMin = 0.f))
+	float TickInterval;
+
+	// Shown by the pickup while the effect can be picked up
+	UPROPERTY(EditDefaultsOnly, Category = "Pickup")
+	UStaticMesh* PickupMesh;
+};
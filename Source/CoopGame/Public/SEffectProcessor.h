@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SEffectProcessor.generated.h"
+
+class USEffectStackComponent;
+
+/**
+ * Runs every effect stack with active effects in one tick, so the stacks and pickups don't need timers or ticks of
+ * their own. Stacks register when an effect is applied and drop out once they're empty. Server only.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASEffectProcessor : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASEffectProcessor();
+
+	// Null on clients
+	static ASEffectProcessor* Get(UWorld* World);
+
+	void RegisterStack(USEffectStackComponent* EffectStack);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	TArray<TWeakObjectPtr<USEffectStackComponent>> Stacks;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SEffectStackComponent.generated.h"
+
+class USEffectData;
+class USHealthComponent;
+class UCharacterMovementComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEffectsChangedSignature, USEffectStackComponent*, EffectStack);
+
+USTRUCT()
+struct FSActiveEffect {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	USEffectData* Effect;
+
+	// Server world time the effect runs out
+	UPROPERTY()
+	float EndTime;
+
+	// Server world time of the next heal
+	UPROPERTY(NotReplicated)
+	float NextTickTime;
+
+	FSActiveEffect() : Effect(nullptr), EndTime(0.f), NextTickTime(0.f) {}
+};
+
+/**
+ * The buffs active on an actor. Only the effect assets and their end times replicate, clients work out the multipliers
+ * themselves. The component doesn't tick, ASEffectProcessor runs every stack in the world in one pass on the server.
+ */
+UCLASS(ClassGroup=(COOP), meta=(BlueprintSpawnableComponent))
+class COOPGAME_API USEffectStackComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USEffectStackComponent();
+
+	// Server side: adds the effect, or restarts it if it's already active
+	void ApplyEffect(USEffectData* Effect);
+
+	// Server side: drops every effect
+	void ClearEffects();
+
+	// Server side: heals that are due and effects that ran out, by ASEffectProcessor. False once nothing is left
+	bool ProcessEffects(float Now);
+
+	float GetDamageMultiplier() const { return DamageMultiplier; }
+
+	// 1 for actors without an effect stack
+	static float GetDamageMultiplier(const AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Effects")
+	bool HasEffect(const USEffectData* Effect) const;
+
+	// Blueprint listeners for cosmetics, broadcast on the server and on clients
+	UPROPERTY(BlueprintAssignable, Category = "Events")
+	FOnEffectsChangedSignature OnEffectsChanged;
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ActiveEffects)
+	TArray<FSActiveEffect> ActiveEffects;
+
+	UFUNCTION()
+	void OnRep_ActiveEffects();
+
+	// Server side: sends the effects and applies them locally
+	void MarkEffectsDirty();
+
+	void UpdateModifiers();
+
+	float DamageMultiplier;
+
+	UPROPERTY(Transient)
+	USHealthComponent* HealthComp;
+
+	UPROPERTY(Transient)
+	UCharacterMovementComponent* MovementComp;
+
+	float BaseMaxWalkSpeed;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SEventBus.generated.h"
+
+class USHealthComponent;
+class UDamageType;
+class AController;
+
+// A health change on any health component in the world
+struct FSDamageEvent {
+	TWeakObjectPtr<USHealthComponent> HealthComp;
+	float Health;
+
+	// Positive for damage, negative for healing
+	float HealthDelta;
+
+	TWeakObjectPtr<const UDamageType> DamageType;
+	TWeakObjectPtr<AController> InstigatedBy;
+	TWeakObjectPtr<AActor> DamageCauser;
+};
+
+struct FSKillEvent {
+	TWeakObjectPtr<AActor> Victim;
+	TWeakObjectPtr<AActor> Killer;
+	TWeakObjectPtr<AController> KillerController;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FSOnDamageEvents, const TArray<FSDamageEvent>&);
+DECLARE_MULTICAST_DELEGATE_OneParam(FSOnKillEvents, const TArray<FSKillEvent>&);
+
+/**
+ * Hands every damage and kill event of a frame to native listeners as one batch in TG_PostUpdateWork.
+ * Meant for listeners that only need to know what happened this frame, such as scoring, stats or UI. Listeners that
+ * must react straight away bind USHealthComponent::OnHealthChangedNative or ASGameMode::OnActorKilledNative instead.
+ * Events are only queued while something is bound, so an unused bus costs nothing.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASEventBus : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASEventBus();
+
+	static ASEventBus* Get(UWorld* World);
+
+	void PublishDamage(const FSDamageEvent& Event);
+
+	void PublishKill(const FSKillEvent& Event);
+
+	// Dispatches and clears the events queued so far
+	void FlushEvents();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	FSOnDamageEvents OnDamageEvents;
+
+	FSOnKillEvents OnKillEvents;
+
+	// Times dynamic, native and batched delivery of NrOfEvents health changes to a single listener
+	static void RunBenchmark(int32 NrOfEvents, FOutputDevice& Ar);
+
+protected:
+	virtual void BeginPlay() override;
+
+	TArray<FSDamageEvent> PendingDamageEvents;
+	TArray<FSKillEvent> PendingKillEvents;
+
+	// The events being broadcast, swapped with the pending ones on each flush
+	TArray<FSDamageEvent> DispatchingDamageEvents;
+	TArray<FSKillEvent> DispatchingKillEvents;
+
+	bool bFlushing;
+
+	int32 BenchmarkEventsReceived;
+
+	// Dynamic delegate target for the benchmark
+	UFUNCTION()
+	void HandleBenchmarkHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta,
+		const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+};
@@ -4,22 +4,53 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SPreloadable.h"
 #include "SExplosiveBarrel.generated.h"
 
 class USHealthComponent;
 class UStaticMeshComponent;
 class URadialForceComponent;
+class USNavObstacleComponent;
 class UParticleSystem;
 class UMaterialInterface;
 
 UCLASS()
-class COOPGAME_API ASExplosiveBarrel : public AActor
+class COOPGAME_API ASExplosiveBarrel : public AActor, public ISPreloadable
 {
 	GENERATED_BODY()
 	
 protected:
 	ASExplosiveBarrel();
 
+	virtual void BeginPlay() override;
+
+	// Puts the barrel back where the level placed it, intact
+	virtual void Reset() override;
+
+	FTransform InitialTransform;
+
+	// Replicates its movement while flying after an explosion, dormant otherwise
+	FTimerHandle TimerHandle_Settle;
+
+	void Settle();
+
+	// Server side: replicates movement while anything pushes the barrel, not only its own explosion
+	UFUNCTION()
+	void OnMeshWake(UPrimitiveComponent* WakeComponent, FName BoneName);
+
+	UFUNCTION()
+	void OnMeshSleep(UPrimitiveComponent* SleepComponent, FName BoneName);
+
+	UPROPERTY(EditDefaultsOnly, Category = "FX")
+	float SettleTime;
+
+	// An exploded barrel moving slower than this after SettleTime stops simulating physics
+	UPROPERTY(EditDefaultsOnly, Category = "FX", meta = (ClampMin = 0.f))
+	float SettleSpeed;
+
+	UPROPERTY(Transient)
+	UMaterialInterface* IntactMaterial;
+
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	USHealthComponent* HealthComp;
 
@@ -29,7 +60,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	URadialForceComponent* RadialForceComp;
 
-	UFUNCTION()
+	// Stands in for the mesh in navigation, which would rebuild tiles every frame the barrel tumbles
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	USNavObstacleComponent* NavObstacleComp;
+
 	void OnHealthChanged(USHealthComponent* OwningHealthComponent, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
 	UPROPERTY(ReplicatedUsing=OnRep_Exploded)
@@ -42,8 +76,11 @@ protected:
 	float ExplosionImpulse;
 
 	UPROPERTY(EditDefaultsOnly, Category = "FX")
-	UParticleSystem* ExplosionEffect;
+	TSoftObjectPtr<UParticleSystem> ExplosionEffect;
 	
 	UPROPERTY(EditDefaultsOnly, Category = "FX")
-	UMaterialInterface* ExplodedMaterial;
+	TSoftObjectPtr<UMaterialInterface> ExplodedMaterial;
+
+public:
+	virtual void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const override;
 };
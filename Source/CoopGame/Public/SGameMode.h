@@ -5,8 +5,10 @@
 #include "SGameMode.generated.h"
 
 enum class EWaveState : uint8;
+class ASTrackerBot;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnActorKilled, AActor*, VictimActor, AActor*, KillerActor, AController*, KillerController);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnActorKilledNative, AActor*, AActor*, AController*);
 
 UCLASS()
 class COOPGAME_API ASGameMode : public AGameModeBase
@@ -19,14 +21,60 @@ public:
 	virtual void StartPlay() override;
 	virtual void Tick(float DeltaSeconds) override;
 
+	// Every player pawn goes through here once possessed, first spawns and respawns alike
+	virtual void SetPlayerDefaults(APawn* PlayerPawn) override;
+
+	// Blueprint listeners, only broadcast while something is bound
 	UPROPERTY(BlueprintAssignable, Category = "GameMode")
 	FOnActorKilled OnActorKilled;
 
+	// C++ listeners, broadcast without going through reflection
+	FOnActorKilledNative OnActorKilledNative;
+
+	void BroadcastActorKilled(AActor* VictimActor, AActor* KillerActor, AController* KillerController);
+
+	// Starts a fresh match on the current map without travelling, resetting every actor in place
+	UFUNCTION(BlueprintCallable, Category = "GameMode")
+	void ResetMatch();
+
+	// Spawns a wave or test bot, reusing a pooled one of the same class when possible
+	UFUNCTION(BlueprintCallable, Category = "GameMode")
+	APawn* AcquireBot(TSubclassOf<APawn> BotClass, const FTransform& SpawnTransform);
+
+	// Keeps a dead or reset bot around for AcquireBot, or destroys it once MaxPooledBots are kept
+	void ReleaseBot(ASTrackerBot* Bot);
+
+	// Load testing: spawns bots of the first wave's first class in a ring around the first player
+	void SpawnTestBots(int32 NrOfBots, float Radius, FOutputDevice& Ar);
+
+	int32 GetWaveCount() const { return WaveCount; }
+
 protected:
-	// Hook for BP to spawn a single bot
+	// Hook for BP to spawn a single bot, only used when the wave has no bot classes or no spawn transform
 	UFUNCTION(BlueprintImplementableEvent, Category = "GameMode")
 	void SpawnNewBot();
 
+	// Spawns the wave's next bot through AcquireBot
+	void SpawnWaveBot();
+
+	// Where the next wave bot appears, a random reachable point around a living player by default
+	UFUNCTION(BlueprintNativeEvent, Category = "GameMode")
+	bool GetBotSpawnTransform(FTransform& OutTransform);
+
+	UPROPERTY(EditDefaultsOnly, Category = "GameMode")
+	float BotSpawnRadius;
+
+	// Pooled bots kept for reuse, more than the largest wave only holds on to hidden actors
+	UPROPERTY(EditDefaultsOnly, Category = "GameMode", meta = (ClampMin = 0))
+	int32 MaxPooledBots;
+
+	// Bot classes wave bots are picked from, streamed in on clients before the wave starts
+	UFUNCTION(BlueprintNativeEvent, Category = "GameMode")
+	TArray<TSubclassOf<APawn>> GetBotClassesForWave(int32 WaveNumber);
+
+	UPROPERTY(EditDefaultsOnly, Category = "GameMode")
+	TArray<TSubclassOf<APawn>> WaveBotClasses;
+
 	void SpawnBotTimerElapsed();
 
 	void StartWave();
@@ -39,6 +87,7 @@ protected:
 
 	FTimerHandle TimerHandle_BotSpawner;
 	FTimerHandle TimerHandle_NextWaveStart;
+	FTimerHandle TimerHandle_MatchReset;
 
 	// Bots to spawn in current wave
 	int32 NrOfBotsToSpawn;
@@ -48,6 +97,13 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "GameMode")
 	float TimeBetweenWaves;
 
+	// Time the game over screen shows before the next match starts
+	UPROPERTY(EditDefaultsOnly, Category = "GameMode")
+	float TimeBeforeMatchReset;
+
+	UPROPERTY(Transient)
+	TArray<ASTrackerBot*> BotPool;
+
 	void CheckAnyPlayerAlive();
 	void GameOver();
 
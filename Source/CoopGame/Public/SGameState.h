@@ -6,6 +6,8 @@
 #include "GameFramework/GameStateBase.h"
 #include "SGameState.generated.h"
 
+class APawn;
+
 UENUM(BlueprintType)
 enum class EWaveState : uint8 {
 	WaitingToStart,
@@ -25,6 +27,11 @@ class COOPGAME_API ASGameState : public AGameStateBase
 public:
 	void SetWaveState(EWaveState NewState);
 
+	EWaveState GetWaveState() const { return WaveState; }
+
+	// Bot classes the next wave will spawn, so clients can stream their assets in while waiting
+	void SetUpcomingBotClasses(const TArray<TSubclassOf<APawn>>& BotClasses);
+
 protected:
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_WaveState, Category = "GameState")
 	EWaveState WaveState;
@@ -32,6 +39,14 @@ protected:
 	UFUNCTION()
 	void OnRep_WaveState(EWaveState OldState);
 
+	UPROPERTY(ReplicatedUsing = OnRep_UpcomingBotClasses)
+	TArray<TSubclassOf<APawn>> UpcomingBotClasses;
+
+	UFUNCTION()
+	void OnRep_UpcomingBotClasses();
+
+	void PreloadUpcomingWave();
+
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
 
 	UFUNCTION(BlueprintImplementableEvent, Category = "GameState")
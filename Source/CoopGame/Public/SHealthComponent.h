@@ -6,7 +6,10 @@
 #include "Components/ActorComponent.h"
 #include "SHealthComponent.generated.h"
 
+class ASEventBus;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FOnHealthChangedSignature, USHealthComponent*, HealthComp, float, Health, float, HealthDelta, const class UDamageType*, DamageType, class AController*, InstigatedBy, AActor*, DamageCauser);
+DECLARE_MULTICAST_DELEGATE_SixParams(FOnHealthChangedNative, USHealthComponent*, float, float, const class UDamageType*, class AController*, AActor*);
 
 UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
 class COOPGAME_API USHealthComponent : public UActorComponent
@@ -17,14 +20,21 @@ public:
 	// Sets default values for this component's properties
 	USHealthComponent();
 
+	// Blueprint listeners, only broadcast while something is bound
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnHealthChangedSignature OnHealthChanged;
 
+	// C++ listeners, broadcast without going through reflection
+	FOnHealthChangedNative OnHealthChangedNative;
+
 	UFUNCTION(BlueprintCallable, Category = "HealthComponent")
 	void Heal(float HealAmount);
 
 	float GetHealth() const;
 
+	// Back to full health and alive again, for actors reused by a match reset
+	void ResetHealth();
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "HealthComponent")
 	uint8 TeamNum;
 
@@ -43,9 +53,16 @@ protected:
 	UFUNCTION()
 	void OnRep_Health(float OldHealth);
 
+	void MarkHealthDirty();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HealthComponent")
 	float DefaultHealth;
 
+	void BroadcastHealthChanged(float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
+
+	UPROPERTY(Transient)
+	ASEventBus* EventBus;
+
 	UFUNCTION()
 	void HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 };
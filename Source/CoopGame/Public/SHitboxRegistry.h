@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SHitboxRegistry.generated.h"
+
+class UPrimitiveComponent;
+
+struct FSHitboxHit {
+	AActor* Actor;
+	UPrimitiveComponent* Component;
+	FName BoneName;
+	EPhysicalSurface SurfaceType;
+
+	FVector Location;
+	FVector Normal;
+
+	// Fraction of the way from the ray's start to its end
+	float Time;
+};
+
+/**
+ * Simplified capsule and sphere hitboxes of pawns, so weapon traces can tell which pawn and which part of it they hit
+ * without a trace against the pawn's physics asset and a physical material lookup. Hitboxes are refreshed into
+ * structure of arrays form once per frame on the game thread, and rays are tested against four of them at a time with
+ * SIMD. Rays can be cast from worker threads once the frame's refresh has run.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASHitboxRegistry : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASHitboxRegistry();
+
+	static ASHitboxRegistry* Get(UWorld* World);
+
+	// A capsule between two sockets of Component, a sphere when they are the same. NAME_None is the component's origin
+	void AddHitbox(UPrimitiveComponent* Component, FName SocketA, FName SocketB, float Radius, EPhysicalSurface SurfaceType);
+
+	void RemoveHitboxes(AActor* Owner);
+
+	// Moves the hitboxes to where their sockets are now, does nothing when already done this frame
+	void Refresh();
+
+	// Nearest hitbox along the ray that doesn't belong to IgnoredActor, reads only what Refresh wrote
+	bool Raycast(const FVector& Start, const FVector& End, const AActor* IgnoredActor, FSHitboxHit& OutHit) const;
+
+	// Casts random rays at the registered hitboxes, through Raycast and through LineTraceSingleByChannel, and logs rays per second
+	static void RunBenchmark(UWorld* World, int32 NrOfRays, FOutputDevice& Ar);
+
+protected:
+	struct FSource {
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		FName SocketA;
+		FName SocketB;
+		float Radius;
+		EPhysicalSurface SurfaceType;
+	};
+
+	TArray<FSource> Sources;
+
+	// One lane per source, padded to a multiple of four with lanes that never hit
+	TArray<float, TAlignedHeapAllocator<16>> AX, AY, AZ;
+
+	// Axis from A to B and its squared length
+	TArray<float, TAlignedHeapAllocator<16>> EX, EY, EZ, ELengthSquared;
+
+	// Negative for hitboxes that can't be hit right now
+	TArray<float, TAlignedHeapAllocator<16>> RadiusSquared;
+
+	TArray<AActor*> LaneOwners;
+	TArray<UPrimitiveComponent*> LaneComponents;
+
+	uint64 LastRefreshFrame;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FRunnableThread;
+class FEvent;
+class FArchive;
+class UWorld;
+
+enum class ESMatchEvent : uint8 {
+	// Subject is an id the other records use, Name what it stands for
+	Name,
+	// Subject killed by Other
+	Kill,
+	// Subject took Value damage from Other
+	Damage,
+	// Subject healed by Value
+	Heal,
+	// Wave Value entered the EWaveState in Arg
+	WaveState,
+	// Subject, a player state, scored Value
+	Score,
+	// Subject spawned, Arg is 1 when it came out of the bot pool
+	Spawn
+};
+
+struct FSMatchLogRecord {
+	ESMatchEvent Type = ESMatchEvent::Name;
+	uint8 Arg = 0;
+
+	// Game world the event happened in, a server process can host several
+	uint32 World = 0;
+
+	// World time in seconds
+	float Time = 0.f;
+
+	// Ids of the actors involved, 0 for none
+	uint32 Subject = 0;
+	uint32 Other = 0;
+
+	float Value = 0.f;
+
+	// Name records only
+	FName Name;
+
+	friend FArchive& operator<<(FArchive& Ar, FSMatchLogRecord& Record);
+};
+
+/**
+ * Structured log of what happened in every match hosted by the process: kills, damage, heals, wave changes, score and
+ * spawns. The game thread only copies fixed size records into a lock-free ring, a writer thread compresses them in
+ * blocks to Saved/Logs/MatchLog-<time>.bin and rotates files by size. Actors are logged by id, with a Name record the
+ * first time an id is used. Toggle with COOP.MatchLog, convert with COOP.MatchLogToCsv or the SMatchLogToCsv commandlet.
+ */
+class COOPGAME_API FSMatchLog : public FRunnable {
+public:
+	static FSMatchLog& Get();
+
+	~FSMatchLog();
+
+	void LogKill(const AActor* Victim, const AActor* Killer);
+
+	void LogDamage(const AActor* Victim, const AActor* DamageCauser, float Damage);
+
+	void LogHeal(const AActor* Target, float HealAmount);
+
+	void LogWaveState(UWorld* World, uint8 WaveState, int32 WaveCount);
+
+	void LogScore(const AActor* PlayerState, float ScoreDelta);
+
+	void LogSpawn(const AActor* Spawned, bool bFromPool);
+
+	// Writes everything queued so far and stops the writer thread, until the next event starts it again
+	void Shutdown();
+
+	// Converts a match log to CSV, one row per event with names resolved
+	static bool ConvertToCsv(const FString& InFileName, const FString& OutFileName, FOutputDevice& Ar);
+
+	// FRunnable
+	virtual uint32 Run() override;
+
+	// FRunnable: asks the writer thread to finish, Shutdown waits for it
+	virtual void Stop() override;
+
+private:
+	FSMatchLog();
+
+	// Game thread only, the queue has a single producer. False when the queue is full and the record was dropped
+	bool Enqueue(FSMatchLogRecord& Record, const UObject* WorldContext);
+
+	// Id for Object, queuing a Name record the first time it's seen
+	uint32 GetId(const UObject* Object);
+
+	// Writer thread: moves queued records into the current block, writing it out once full or after a while
+	void Drain(bool bFlushBlock);
+
+	void WriteBlock();
+
+	void OpenFile();
+
+	void CloseFile();
+
+	static bool IsEnabled();
+
+	TCircularQueue<FSMatchLogRecord> Queue;
+
+	// Game thread: ids that already have a Name record
+	TMap<uint32, FName> NamedIds;
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	FThreadSafeBool bStopping;
+
+	// Writer thread from here on
+	TArray<uint8> Block;
+	TArray<uint8> CompressedBlock;
+	double LastBlockTime;
+
+	// Every name so far, repeated at the start of each rotated file so it can be read on its own
+	TMap<uint32, FName> FileNames;
+
+	FArchive* FileWriter;
+};
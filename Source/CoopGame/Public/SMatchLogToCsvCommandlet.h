@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SMatchLogToCsvCommandlet.generated.h"
+
+/**
+ * Converts match logs to CSV offline, without starting the game:
+ *   UE4Editor-Cmd CoopGame.uproject -run=SMatchLogToCsv -In=<file or directory> [-Out=<file>]
+ * A directory converts every MatchLog-*.bin in it, each to a CSV next to it.
+ */
+UCLASS()
+class USMatchLogToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USMatchLogToCsvCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
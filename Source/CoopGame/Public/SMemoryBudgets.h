@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SMemoryTags.h"
+#include "SMemoryBudgets.generated.h"
+
+// Memory of a world's CoopGame objects per memory tag, indexed from ESMemoryTag::Bots
+struct FSMemoryReport {
+	int64 Bytes[NrOfMemoryTags];
+	int32 Objects[NrOfMemoryTags];
+};
+
+/**
+ * Measures how much memory each CoopGame category holds in a world and warns when one goes over its budget in
+ * COOP.MemoryBudgets, every COOP.MemoryBudgetInterval seconds. Objects are counted the way "obj list" counts them,
+ * by serializing them into a counting archive and adding their resource size, so this works in any build and
+ * without -llm. The checks count COOP.MemoryBudgetObjectsPerFrame objects a frame so they don't hitch, COOP.DumpMemory
+ * counts everything at once. Allocations made under the matching LLM tags show up in "stat LLMFULL" when running with -llm.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASMemoryBudgets : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASMemoryBudgets();
+
+	static ASMemoryBudgets* Get(UWorld* World);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Counts the whole world in one go, only for on demand reports
+	static void Measure(UWorld* World, FSMemoryReport& OutReport);
+
+	// Per category breakdown against the budgets, COOP.DumpMemory
+	static void Dump(UWorld* World, FOutputDevice& Ar);
+
+protected:
+	// Warns about the categories that went over or back under their budget
+	void CheckBudgets(const FSMemoryReport& Report);
+
+	bool bOverBudget[NrOfMemoryTags];
+
+	// The check in progress: what's left to count and the totals so far
+	TArray<TWeakObjectPtr<UObject>> PendingObjects;
+	int32 NextPendingObject;
+	FSMemoryReport PendingReport;
+};
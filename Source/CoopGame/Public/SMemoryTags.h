@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Low level memory tracker tags for the game's own systems, listed by "stat LLM" and -llmcsv when running with -llm
+enum class ESMemoryTag : int32 {
+	Bots = (int32)ELLMTag::ProjectTagStart,
+	Navigation,
+	Projectiles,
+	Events,
+	Replication,
+	Weapons,
+	Characters,
+	Pickups,
+	Effects,
+
+	// One past the last tag
+	End
+};
+
+static const int32 NrOfMemoryTags = (int32)ESMemoryTag::End - (int32)ESMemoryTag::Bots;
+
+// Short name of the tag, as used by COOP.MemoryBudgets and COOP.DumpMemory
+const TCHAR* GetMemoryTagName(ESMemoryTag Tag);
+
+// Attributes allocations in the current scope to one of the tags above
+#define COOP_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)(Tag))
+
+// Names the tags for the tracker, called once on module startup
+void RegisterMemoryTags();
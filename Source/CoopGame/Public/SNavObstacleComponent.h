@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavRelevantComponent.h"
+#include "SNavObstacleComponent.generated.h"
+
+class UNavArea;
+
+/**
+ * Marks a movable prop's footprint in the navmesh as an area rather than cutting it out of the geometry. The footprint
+ * only moves when ASNavObstacleManager commits it, once the prop has come to rest, so a prop knocked around by an
+ * explosion dirties its tiles once instead of every physics frame. The prop's own meshes shouldn't affect navigation.
+ */
+UCLASS(ClassGroup=(COOP), meta=(BlueprintSpawnableComponent), hidecategories=(Activation))
+class COOPGAME_API USNavObstacleComponent : public UNavRelevantComponent
+{
+	GENERATED_BODY()
+
+public:
+	USNavObstacleComponent();
+
+	virtual void CalcAndCacheBounds() const override;
+	virtual void GetNavigationData(FNavigationRelevantData& Data) const override;
+
+	// Whether the owner moved or turned far enough from its footprint to be worth a rebuild
+	bool NeedsCommit(float MoveThreshold) const;
+
+	// Moves the footprint to where the owner is now. Navigation rebuilds the tiles under the old and the new footprint
+	void CommitTransform(FBox& OutOldBounds, FBox& OutNewBounds);
+
+protected:
+	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Bots path around the prop at a cost instead of treating it as a wall
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+	TSubclassOf<UNavArea> AreaClass;
+
+	// Half size of the footprint when the owner's root has no bounds of its own
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+	FVector FailsafeExtent;
+
+	// Owner's root bounds in its own space
+	FBox LocalBounds;
+
+	// Owner's root transform as navigation last saw it
+	FTransform CommittedTransform;
+
+	USceneComponent* GetTrackedComponent() const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SNavObstacleManager.generated.h"
+
+class USNavObstacleComponent;
+
+/**
+ * Decides when movable props' navigation footprints move. A prop has to stay still for COOP.NavObstacleSettleTime
+ * before its footprint follows it, and only COOP.NavObstacleBudget footprints move per second, the rest wait their
+ * turn. Server only, where bots path.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASNavObstacleManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASNavObstacleManager();
+
+	// Null on clients
+	static ASNavObstacleManager* Get(UWorld* World);
+
+	void AddObstacle(USNavObstacleComponent* Obstacle);
+
+	void RemoveObstacle(USNavObstacleComponent* Obstacle);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	struct FObstacle {
+		TWeakObjectPtr<USNavObstacleComponent> Component;
+		FVector LastLocation;
+		float LastMoveTime;
+	};
+
+	TArray<FObstacle> Obstacles;
+
+	// Footprint moves that can be spent right now, refilled at COOP.NavObstacleBudget per second
+	float UpdateTokens;
+
+	// Navmesh tiles dirtied since StatWindowStart, for the per second stat
+	int32 WindowTiles;
+	float StatWindowStart;
+
+	// Tiles under Box, by the navmesh's tile size
+	void CollectTiles(const FBox& Box, float TileSize, TSet<FIntPoint>& OutTiles) const;
+};
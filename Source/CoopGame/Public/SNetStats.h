@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class AActor;
+class UNetConnection;
+class FArchive;
+class UStruct;
+
+// Bytes attributed to a single replicated property or RPC on one connection
+struct FSNetStatEntry {
+	bool bIsRPC = false;
+
+	// Bits accumulated during the current one second window
+	int32 CurrentBits = 0;
+
+	int32 LastSecondBytes = 0;
+	int32 HighWaterBytes = 0;
+	int64 TotalBytes = 0;
+};
+
+struct FSConnectionNetStats {
+	FString Name;
+
+	TMap<FName, FSNetStatEntry> Sent;
+	TMap<FName, FSNetStatEntry> Received;
+
+	// Totals reported by the connection itself, to compare the attributed bytes against
+	int32 InBytesPerSecond = 0;
+	int32 OutBytesPerSecond = 0;
+};
+
+/**
+ * Attributes network bytes to the CoopGame properties and RPCs that caused them, per connection and per second.
+ * Property sizes are measured by net serializing the current value, RPCs add a fixed header estimate on top of their parameters,
+ * so numbers are payload estimates rather than exact wire bytes. Toggle with COOP.NetStats, show with COOP.NetStatsOnScreen,
+ * dump with COOP.DumpNetStats and stream to Saved/Profiling with COOP.NetStatsCSV. Off by default, measuring runs on every
+ * replicated property change.
+ */
+class COOPGAME_API FSNetStats {
+public:
+	static FSNetStats& Get();
+
+	~FSNetStats();
+
+	// Server changed a replicated property, counted once for every client connection with an open channel to the owning actor
+	void RecordPropertySent(const UObject* Object, FName PropertyName, bool bSkipOwner = false);
+
+	// Client received a replicated property through its RepNotify
+	void RecordPropertyReceived(const UObject* Object, FName PropertyName);
+
+	void RecordRPCSent(const AActor* Actor, FName FunctionName, int32 ParamBits = 0);
+
+	void RecordRPCReceived(const AActor* Actor, FName FunctionName, int32 ParamBits = 0);
+
+	void Dump(FOutputDevice& Ar) const;
+
+	// Approximate number of bits needed to net serialize the property's current value
+	int32 MeasurePropertyBits(const UObject* Object, FName PropertyName);
+
+	// Same for every replicated field of a struct value
+	static int32 MeasureStructBits(const UStruct* Struct, const void* Data);
+
+	// Stops the per second roll and closes the CSV, while the core ticker is still around
+	void Shutdown();
+
+private:
+	FSNetStats();
+
+	void Record(UNetConnection* Connection, FName Name, int32 Bits, bool bIsRPC, bool bSent);
+
+	bool Roll(float DeltaTime);
+
+	void WriteCSV(double Time);
+
+	static bool IsEnabled();
+
+	TMap<TWeakObjectPtr<UNetConnection>, FSConnectionNetStats> Connections;
+
+	// Properties already looked up by name, per class
+	TMap<TWeakObjectPtr<UClass>, TMap<FName, UProperty*>> PropertyCache;
+
+	FDelegateHandle TickerHandle;
+
+	FArchive* CSVWriter;
+};
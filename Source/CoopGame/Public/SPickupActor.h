@@ -8,7 +8,9 @@
 
 class USphereComponent;
 class UDecalComponent;
+class UStaticMeshComponent;
 class ASPowerupActor;
+class USEffectData;
 
 UCLASS()
 class COOPGAME_API ASPickupActor : public AActor
@@ -21,6 +23,9 @@ public:
 
 	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
 
+	// Respawns the powerup straight away if it was picked up
+	virtual void Reset() override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -31,9 +36,26 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	UDecalComponent* DecalComp;
 
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	UStaticMeshComponent* MeshComp;
+
+	// Blueprint powerup spawned for each pickup, used when no Effect is set
 	UPROPERTY(EditInstanceOnly, Category = "PickupActor")
 	TSubclassOf<ASPowerupActor> PowerUpClass;
 
+	// Applied straight to the effect stack of whoever picks it up, without spawning a powerup
+	UPROPERTY(EditInstanceOnly, Category = "PickupActor")
+	USEffectData* Effect;
+
+	UPROPERTY(ReplicatedUsing = OnRep_EffectAvailable)
+	bool bEffectAvailable;
+
+	UFUNCTION()
+	void OnRep_EffectAvailable();
+
+	// Server side: replicates the change and shows or hides the mesh
+	void SetEffectAvailable(bool bNewAvailable);
+
 	UFUNCTION()
 	void Respawn();
 
@@ -43,4 +65,6 @@ protected:
 	FTimerHandle TimerHandle_RespawnTimer;
 
 	ASPowerupActor* PowerUpInstance;
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
 };
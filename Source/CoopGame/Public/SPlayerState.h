@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerState.h"
+#include "SBotMovementReplicator.h"
 #include "SPlayerState.generated.h"
 
 /**
@@ -18,5 +19,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "PlayerState")
 	void AddScore(float ScoreDelta);
 	
-	
+	// Movement of the bots due an update for this player, sent by ASBotMovementReplicator
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveBotMovement(float ServerTime, const TArray<FSBotMovementUpdate>& Updates);
 };
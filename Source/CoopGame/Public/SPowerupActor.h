@@ -14,6 +14,9 @@ public:
 
 	void ActivatePowerup(AActor* ActivateFor);
 
+	// Expires the powerup early if it's active
+	virtual void Reset() override;
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "Powerups")
 	void OnActivated(AActor* ActivateFor);
 
@@ -43,6 +46,8 @@ protected:
 	UFUNCTION()
 	void OnTickPowerup();
 
+	void Expire();
+
 	UPROPERTY(ReplicatedUsing=OnRep_PowerupActive)
 	bool bIsPowerupActive;
 
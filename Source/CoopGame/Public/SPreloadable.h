@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SPreloadable.generated.h"
+
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class COOPGAME_API USPreloadable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+// Actors whose cosmetic assets are soft referenced and streamed in by ASAssetPreloader
+class COOPGAME_API ISPreloadable
+{
+	GENERATED_BODY()
+
+public:
+	// Called on the class default object, adds every soft referenced asset instances of the class need
+	virtual void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const = 0;
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
+#include "SProjectileManager.generated.h"
+
+class ASWeapon;
+class UStaticMesh;
+class UStaticMeshComponent;
+class UParticleSystem;
+class USoundBase;
+class UDamageType;
+
+// Ballistics, damage and visuals of a projectile fired by a projectile weapon
+USTRUCT(BlueprintType)
+struct FSProjectileParams {
+	GENERATED_BODY()
+
+public:
+	FSProjectileParams();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	float Speed;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	float GravityScale;
+
+	// Projectile explodes once this runs out, even without hitting anything
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (ClampMin = 0.f))
+	float LifeSpan;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (ClampMin = 0.f))
+	float CollisionRadius;
+
+	// Explode on the first blocking hit, otherwise bounce until LifeSpan runs out
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	bool bExplodeOnImpact;
+
+	// Fraction of velocity kept after a bounce
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (ClampMin = 0.f, ClampMax = 1.f))
+	float Bounciness;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	float Damage;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	float DamageRadius;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	TSubclassOf<UDamageType> DamageType;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	UStaticMesh* VisualMesh;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	UParticleSystem* ExplosionEffect;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	USoundBase* ExplosionSound;
+};
+
+// Sent to clients when the server fires a projectile
+USTRUCT()
+struct FSProjectileSpawnEvent {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	uint16 ProjectileId;
+
+	UPROPERTY()
+	UClass* WeaponClass;
+
+	UPROPERTY()
+	AActor* Instigator;
+
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	UPROPERTY()
+	FVector_NetQuantize Velocity;
+};
+
+// Sent to clients when a projectile explodes on the server
+USTRUCT()
+struct FSProjectileExplodeEvent {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	uint16 ProjectileId;
+
+	UPROPERTY()
+	UClass* WeaponClass;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	// Surface the projectile exploded against, SurfaceType_Max when it went off in the air
+	UPROPERTY()
+	TEnumAsByte<EPhysicalSurface> SurfaceType;
+};
+
+// Lightweight in-flight projectile, simulated by the manager instead of being an actor
+struct FSProjectile {
+	FVector Position;
+	FVector Velocity;
+	float LifeRemaining;
+	uint16 ProjectileId;
+
+	const FSProjectileParams* Params;
+	UClass* WeaponClass;
+
+	TWeakObjectPtr<AActor> Instigator;
+	TWeakObjectPtr<AController> InstigatorController;
+
+	// Pooled mesh showing the projectile, null on dedicated servers
+	UStaticMeshComponent* Visual;
+};
+
+/**
+ * Simulates every projectile in the world as plain structs with one batched sweep pass per frame.
+ * The server owns the authoritative simulation and applies explosion damage, clients receive compact
+ * spawn and explode events and run a cosmetic copy of the simulation on pooled mesh components.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASProjectileManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASProjectileManager();
+
+	// Server spawns the manager on demand, clients only find the replicated one
+	static ASProjectileManager* Get(UWorld* World);
+
+	void SpawnProjectile(ASWeapon* Weapon, const FVector& Origin, const FVector& Direction);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Drops every projectile in flight, clients let their cosmetic copies run out
+	virtual void Reset() override;
+
+	static const FSProjectileParams* GetProjectileParams(UClass* WeaponClass);
+
+protected:
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastSpawnProjectiles(const TArray<FSProjectileSpawnEvent>& Events);
+
+	// Reliable: the server has already applied the damage, a lost explosion would leave clients with damage out of nowhere
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastExplodeProjectiles(const TArray<FSProjectileExplodeEvent>& Events);
+
+	void AddProjectile(uint16 ProjectileId, UClass* WeaponClass, AActor* Instigator, AController* InstigatorController, const FVector& Origin, const FVector& Velocity);
+
+	void RemoveProjectileAt(int32 Index);
+
+	void Explode(const FSProjectile& Projectile, const FVector& Location, EPhysicalSurface SurfaceType);
+
+	void PlayExplosionEffects(const FSProjectileParams& Params, const FVector& Location, EPhysicalSurface SurfaceType);
+
+	UStaticMeshComponent* AcquireVisual(UStaticMesh* Mesh);
+
+	void ReleaseVisual(UStaticMeshComponent* Visual);
+
+	TArray<FSProjectile> Projectiles;
+
+	// Sweep results of the current step, indexed like Projectiles
+	TArray<FHitResult> StepHits;
+	TArray<bool> StepBlockingHits;
+
+	TArray<FSProjectileSpawnEvent> PendingSpawnEvents;
+	TArray<FSProjectileExplodeEvent> PendingExplodeEvents;
+
+	uint16 NextProjectileId;
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> VisualPool;
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> FreeVisuals;
+};
@@ -4,19 +4,35 @@
 
 #include "CoreMinimal.h"
 #include "SWeapon.h"
+#include "SProjectileManager.h"
 #include "SProjectileWeapon.generated.h"
 
 /**
- * 
+ * Legacy projectile weapon, fires ProjectileParams when no WeaponData is set
  */
 UCLASS()
 class COOPGAME_API ASProjectileWeapon : public ASWeapon
 {
 	GENERATED_BODY()
 	
+public:
+	ASProjectileWeapon();
+
+	virtual const FSProjectileParams* GetProjectileParams() const override;
+
 protected:
-	virtual void Fire() override;
+	virtual void BeginPlay() override;
+
+	// Fills ProjectileParams from the projectile actor older weapons were set up with, once per class
+	void MigrateProjectileClass();
 
 	UPROPERTY(EditDefaultsOnly, Category = "ProjectileWeapon")
+	FSProjectileParams ProjectileParams;
+
+	// Projectile actor this weapon spawned before projectiles were simulated by ASProjectileManager. Only kept so assets
+	// saved with it, such as BP_GrenadeLauncher, still fire the same grenade
+	UPROPERTY()
 	TSubclassOf<AActor> ProjectileClass;
+
+	bool bMigratedProjectileClass;
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UNetConnection;
+
+/**
+ * Server side limits on the RPCs a client connection may call. Every connection gets a budget of calls per second,
+ * calls over it are dropped before they do any work. Calls dropped here or by per-actor checks such as a weapon's fire
+ * rate are counted per connection and function, and logged at most once a second per connection so flood attempts show
+ * up in server logs. Tune with COOP.ServerRPCBudget, dump with COOP.DumpRPCRejections.
+ */
+class COOPGAME_API FSRPCGovernor {
+public:
+	static FSRPCGovernor& Get();
+
+	// Takes one call from the budget of the connection owning Actor, false if the call has to be dropped. MinCallsPerSecond
+	// raises the budget for callers that can legitimately call faster, such as a weapon's fire rate
+	bool ConsumeServerRPC(const AActor* Actor, FName FunctionName, float MinCallsPerSecond = 0.f);
+
+	// Counts a call that was dropped for Reason
+	void RecordRejected(const AActor* Actor, FName FunctionName, const TCHAR* Reason);
+
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+	struct FConnectionBudget {
+		FString Name;
+
+		float Tokens = 0.f;
+		double LastRefillTime = 0.0;
+		double LastWarningTime = 0.0;
+
+		int32 TotalRejected = 0;
+		TMap<FName, int32> Rejected;
+	};
+
+	FConnectionBudget* FindBudget(const AActor* Actor);
+
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionBudget> Connections;
+};
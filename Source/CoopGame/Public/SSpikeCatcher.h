@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "SSpikeCatcher.generated.h"
+
+// Work a world did since its spike catcher's last sample. Game thread only
+struct COOPGAME_API FSFrameCounters {
+	int32 PathsRequested = 0;
+	int32 WeaponTraces = 0;
+	int32 DamageEvents = 0;
+
+	// Counters of the world's spike catcher, or scratch ones nobody reads when the world doesn't have one
+	static FSFrameCounters& Get(const UObject* WorldContext);
+
+private:
+	friend class ASSpikeCatcher;
+
+	static TMap<const UWorld*, FSFrameCounters>& GetWorldCounters();
+};
+
+struct FSFrameSample {
+	double Time;
+	float FrameMs;
+	float GameThreadMs;
+
+	int32 BotsAlive;
+	int32 PathsRequested;
+	int32 WeaponTraces;
+	int32 DamageEvents;
+	int32 NetBytesIn;
+	int32 NetBytesOut;
+};
+
+/**
+ * Watches the server's frame time and keeps the last COOP.SpikeHistoryFrames frames of CoopGame counters in a ring
+ * buffer. When a frame takes longer than COOP.SpikeThresholdMs, the buffer is written to Saved/Profiling with the
+ * wave state and wave count, and a stats capture of the next COOP.SpikeCaptureSeconds is started next to it.
+ * Null on clients, and on listen servers unless COOP.SpikeCatcher is 2.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASSpikeCatcher : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASSpikeCatcher();
+
+	static ASSpikeCatcher* Get(UWorld* World);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Writes the ring buffer to disk on a worker thread, Reason ends up in the file
+	void DumpSpike(const FString& Reason);
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void Sample(float FrameMs);
+
+	void StartCapture(const FString& Name);
+
+	void StopCapture();
+
+	TArray<FSFrameSample> Samples;
+
+	// Where the next sample goes once the buffer is full
+	int32 NextSample;
+
+	double LastFrameTime;
+	double LastDumpTime;
+
+	uint32 LastNetBytesIn;
+	uint32 LastNetBytesOut;
+
+	bool bCapturing;
+
+	FTimerHandle TimerHandle_StopCapture;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "SSurfaceSettings.generated.h"
+
+class UParticleSystem;
+class USoundBase;
+class UMaterialInterface;
+
+USTRUCT()
+struct FSSurfaceSettingsEntry {
+	GENERATED_BODY()
+
+public:
+	FSSurfaceSettingsEntry();
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	TEnumAsByte<EPhysicalSurface> SurfaceType;
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	float DamageMultiplier;
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	TSoftObjectPtr<UParticleSystem> ImpactEffect;
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	TSoftObjectPtr<USoundBase> ImpactSound;
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	TSoftObjectPtr<UMaterialInterface> ImpactDecal;
+
+	UPROPERTY(EditAnywhere, Category = "Surface")
+	FVector DecalSize;
+
+	UPROPERTY(EditAnywhere, Category = "Surface", meta = (ClampMin = 0.f))
+	float DecalLifeSpan;
+};
+
+// Flat per-surface lookup tables, indexed directly by EPhysicalSurface
+struct FSSurfaceTable {
+	float DamageMultipliers[SurfaceType_Max];
+	UParticleSystem* ImpactEffects[SurfaceType_Max];
+	USoundBase* ImpactSounds[SurfaceType_Max];
+	UMaterialInterface* ImpactDecals[SurfaceType_Max];
+	FVector DecalSizes[SurfaceType_Max];
+	float DecalLifeSpans[SurfaceType_Max];
+
+	// Plays the surface's impact sound and decal, and its effect unless EffectOverride is given
+	void PlayImpact(UObject* WorldContextObject, EPhysicalSurface SurfaceType, const FVector& Location, const FRotator& Rotation, UParticleSystem* EffectOverride = nullptr) const;
+};
+
+/**
+ * Damage multipliers and impact cosmetics per physical surface, shared by every hitscan and projectile hit.
+ * Surfaces without an entry use DefaultSurface.
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Surfaces"))
+class COOPGAME_API USSurfaceSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	USSurfaceSettings();
+
+	// Built from the settings on first use
+	static const FSSurfaceTable& GetTable();
+
+	virtual FName GetCategoryName() const override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	UPROPERTY(config, EditAnywhere, Category = "Surfaces")
+	FSSurfaceSettingsEntry DefaultSurface;
+
+	UPROPERTY(config, EditAnywhere, Category = "Surfaces")
+	TArray<FSSurfaceSettingsEntry> Surfaces;
+
+private:
+	void BuildTable();
+
+	FSSurfaceTable Table;
+
+	bool bTableBuilt;
+
+	// Keeps the assets referenced by the table loaded
+	UPROPERTY(Transient)
+	TArray<UObject*> TableAssets;
+};
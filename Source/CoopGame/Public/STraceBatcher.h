@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "STraceBatcher.generated.h"
+
+class ASWeapon;
+class ASHitboxRegistry;
+
+// A single weapon trace waiting to be resolved by the batcher
+struct FSWeaponTrace {
+	FVector Start;
+	FVector End;
+	FVector ShotDirection;
+
+	// Index of the pellet within its shot, 0 for the first (or only) pellet
+	int32 PelletIndex;
+
+	TWeakObjectPtr<ASWeapon> Weapon;
+	TWeakObjectPtr<AActor> WeaponOwner;
+};
+
+/**
+ * Collects every weapon trace issued during a frame and resolves them together in TG_PostUpdateWork.
+ * Traces are tested against the pawns' hitboxes first and only need a world trace to check nothing is in the way.
+ * Otherwise they run against simple collision first and are only refined against complex collision of the component that was hit,
+ * with large batches spread across worker threads. Results are handed back to weapons on the game thread in submission order.
+ */
+UCLASS(NotPlaceable, Transient)
+class COOPGAME_API ASTraceBatcher : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ASTraceBatcher();
+
+	static ASTraceBatcher* Get(UWorld* World);
+
+	void QueueTrace(const FSWeaponTrace& Trace);
+
+	// Resolves every queued trace and dispatches the results
+	void FlushTraces();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Hitbox or simple-then-complex trace of a single weapon shot, safe to call from worker threads once Hitboxes is refreshed
+	static bool ResolveTrace(UWorld* World, const ASHitboxRegistry* Hitboxes, const FSWeaponTrace& Trace, FHitResult& OutHit, EPhysicalSurface& OutSurfaceType);
+
+protected:
+	TArray<FSWeaponTrace> PendingTraces;
+
+	TArray<FHitResult> Results;
+	TArray<bool> BlockingHits;
+	TArray<TEnumAsByte<EPhysicalSurface>> SurfaceTypes;
+
+	UPROPERTY(Transient)
+	ASHitboxRegistry* Hitboxes;
+};
@@ -4,11 +4,17 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SWeaponData.h"
+#include "SPreloadable.h"
 #include "SWeapon.generated.h"
 
 class UCameraShake;
 class USkeletalMeshComponent;
 class UParticleSystem;
+class ASTraceBatcher;
+class ASHitboxRegistry;
+class ASProjectileManager;
+struct FSWeaponTrace;
 
 // Contains information of a hit scan weapon line trace
 USTRUCT()
@@ -23,8 +29,41 @@ public:
 	FVector_NetQuantize TraceTo;
 };
 
+// Every pellet of the last hit scan shot, so remote clients see the whole spread
+USTRUCT()
+struct FHitScanShot {
+	GENERATED_BODY()
+
+public:
+	// Bumped every shot, so a shot with the same traces as the last one still replicates
+	UPROPERTY()
+	uint8 ShotCount;
+
+	UPROPERTY()
+	TArray<FHitScanTrace> Pellets;
+
+	FHitScanShot() : ShotCount(0) {}
+};
+
+// Firing config resolved once from USWeaponData, or from the legacy weapon properties when no data asset is set
+struct FSWeaponConfig {
+	ESWeaponFireMode FireMode;
+	float BaseDamage;
+	float SpreadHalfRad;
+	int32 PelletCount;
+	TSubclassOf<UDamageType> DamageType;
+
+	// Null when damage doesn't fall off with distance
+	const FRichCurve* DamageFalloff;
+
+	float SurfaceDamageMultipliers[SurfaceType_Max];
+
+	// This weapon's default or flesh effect for surfaces without a table effect, null otherwise
+	const TSoftObjectPtr<UParticleSystem>* FallbackImpactEffects[SurfaceType_Max];
+};
+
 UCLASS()
-class COOPGAME_API ASWeapon : public AActor
+class COOPGAME_API ASWeapon : public AActor, public ISPreloadable
 {
 	GENERATED_BODY()
 	
@@ -51,21 +90,69 @@ public:
 
 	float TimeBetweenShots;
 
-	UPROPERTY(ReplicatedUsing=OnRep_HitScanTrace)
-	FHitScanTrace HitScanTrace;
+	UPROPERTY(ReplicatedUsing=OnRep_HitScanShot)
+	FHitScanShot HitScanShot;
 
 	UFUNCTION()
-	void OnRep_HitScanTrace();
-	
+	void OnRep_HitScanShot();
+
+	// Applies damage and effects for a resolved shot trace
+	void HandleShotTrace(const FSWeaponTrace& Trace, const FHitResult& Hit, bool bBlockingHit, EPhysicalSurface SurfaceType);
+
+	virtual const FSProjectileParams* GetProjectileParams() const;
+
+	virtual void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const override;
+
 
 protected:
 	virtual void BeginPlay() override;
 
+	// Server side fire rate governor: a bucket of shots refilled at the fire rate, so clients can't fire faster than the weapon
+	float FireTokens;
+	float LastFireTokenTime;
+
+	// Fastest rate the server accepts this weapon's shots at, fire rate plus COOP.FireRateTolerance
+	float GetMaxServerShotsPerSecond() const;
+
+	// Cheap checks on a client's ServerFire before any trace runs. Sets OutReason when the shot has to be dropped
+	bool CanServerFire(const TCHAR*& OutReason);
+
+	// Picks the specialised fire and damage routines for this weapon's config
+	void ResolveWeaponConfig();
+
+	template<bool bMultiPellet>
+	void FireHitScan(AActor* WeaponOwner, const FVector& EyeLocation, const FRotator& EyeRotation);
+
+	void FireProjectile(AActor* WeaponOwner, const FVector& EyeLocation, const FRotator& EyeRotation);
+
+	template<bool bDamageFalloff>
+	float ComputeShotDamage(const FHitResult& Hit, EPhysicalSurface SurfaceType) const;
+
+	typedef void (ASWeapon::*FFireRoutine)(AActor*, const FVector&, const FRotator&);
+	typedef float (ASWeapon::*FDamageRoutine)(const FHitResult&, EPhysicalSurface) const;
+
+	FFireRoutine FireRoutine;
+	FDamageRoutine DamageRoutine;
+
+	FSWeaponConfig Config;
+
+	// When set, overrides the legacy weapon properties below
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	USWeaponData* WeaponData;
+
+	// Fire mode used when no WeaponData is set
+	ESWeaponFireMode DefaultFireMode;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	USkeletalMeshComponent* MeshComp;
 
 	void PlayFireEffects(FVector TracerEndPoint);
 
+	// Camera shake and recoil, played only on the machine of the player holding the weapon
+	void PlayOwnerFeedback();
+
+	void PlayTracerEffect(FVector TracerEndPoint);
+
 	void PlayImpactEffects(EPhysicalSurface SurfaceType, FVector ImpactPoint);
 
 
@@ -74,16 +161,16 @@ protected:
 	TSubclassOf<UDamageType> DamageType;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	UParticleSystem* MuzzleEffect;
+	TSoftObjectPtr<UParticleSystem> MuzzleEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	UParticleSystem* DefaultImpactEffect;
+	TSoftObjectPtr<UParticleSystem> DefaultImpactEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	UParticleSystem* FleshImpactEffect;
+	TSoftObjectPtr<UParticleSystem> FleshImpactEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	UParticleSystem* TracerEffect;
+	TSoftObjectPtr<UParticleSystem> TracerEffect;
 
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	FName MuzzleSocketName;
@@ -92,7 +179,11 @@ protected:
 	FName TracerTargetName;
 
 	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
-	TSubclassOf<UCameraShake> FireCamShake;
+	TSoftClassPtr<UCameraShake> FireCamShake;
+
+	// Degrees the owner's aim kicks up with every shot
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float RecoilPitch;
 
 	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
 	float BaseDamage;
@@ -100,4 +191,17 @@ protected:
 	// Bullet spread in degrees
 	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = 0.f))
 	float BulletSpread;
+
+	// Number of traces per shot, each with its own spread
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = 1))
+	int32 PelletCount;
+
+	UPROPERTY(Transient)
+	ASTraceBatcher* TraceBatcher;
+
+	UPROPERTY(Transient)
+	ASHitboxRegistry* Hitboxes;
+
+	UPROPERTY(Transient)
+	ASProjectileManager* ProjectileManager;
 };
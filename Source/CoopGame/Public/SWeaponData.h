@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Curves/CurveFloat.h"
+#include "SProjectileManager.h"
+#include "SWeaponData.generated.h"
+
+class UDamageType;
+
+UENUM(BlueprintType)
+enum class ESWeaponFireMode : uint8 {
+	HitScan,
+	Projectile
+};
+
+USTRUCT(BlueprintType)
+struct FSSurfaceDamageMultiplier {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	TEnumAsByte<EPhysicalSurface> SurfaceType;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float Multiplier;
+};
+
+/**
+ * Defines how a weapon fires. Resolved into a specialised fire routine when the weapon begins play,
+ * so a new weapon is a new data asset rather than a new ASWeapon subclass.
+ */
+UCLASS(BlueprintType)
+class COOPGAME_API USWeaponData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	USWeaponData();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	ESWeaponFireMode FireMode;
+
+	// RPM
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = 1.f))
+	float RateOfFire;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	TSubclassOf<UDamageType> DamageType;
+
+	UPROPERTY(EditDefaultsOnly, Category = "HitScan")
+	float BaseDamage;
+
+	// Damage multiplier by hit distance in cm, leave empty for no falloff
+	UPROPERTY(EditDefaultsOnly, Category = "HitScan")
+	FRuntimeFloatCurve DamageFalloff;
+
+	// Bullet spread in degrees
+	UPROPERTY(EditDefaultsOnly, Category = "HitScan", meta = (ClampMin = 0.f))
+	float BulletSpread;
+
+	// Number of traces per shot, each with its own spread
+	UPROPERTY(EditDefaultsOnly, Category = "HitScan", meta = (ClampMin = 1))
+	int32 PelletCount;
+
+	// Applied on top of the project wide multipliers in the Surfaces settings
+	UPROPERTY(EditDefaultsOnly, Category = "HitScan")
+	TArray<FSSurfaceDamageMultiplier> SurfaceDamageMultipliers;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	FSProjectileParams ProjectileParams;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+// Finds the single manager actor of type T in the world, spawning a transient one if requested and none exists yet
+template<class T>
+T* GetWorldManager(UWorld* World, bool bSpawnIfMissing = true) {
+	if (!World) { return nullptr; }
+
+	for (TActorIterator<T> It(World); It; ++It) {
+		if (!It->IsPendingKill()) {
+			return *It;
+		}
+	}
+
+	if (!bSpawnIfMissing) { return nullptr; }
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	return World->SpawnActor<T>(T::StaticClass(), FTransform::Identity, SpawnParams);
+}